@@ -0,0 +1,38 @@
+# Build helpers of the user interface, shared by the application and the tests which link the
+# screens.
+
+set(ZEPHYRWATCH_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+
+# The screens and the user interface modules they need. The application globs them, the tests link
+# them with this list.
+set(ZEPHYRWATCH_SCREEN_SOURCES
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/screenmanager.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/screentransition.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/navigation.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/appregistry.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/utils.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/styles/widgetstyle.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/widgets/digitclock/digitclock.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/screens/home/home.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/screens/menu/menu.c
+    ${ZEPHYRWATCH_ROOT}/src/userinterface/screens/blepairing/blepairing.c)
+
+# The home screen clock is blitted from pre-rendered digits instead of the Montserrat 46 font. The
+# glyphs are rendered from LVGL's font source, which is not compiled into the image. The atlas is
+# generated into the build directory, and added to the target.
+function(zephyrwatch_add_digit_atlas target)
+    set(digit_atlas ${CMAKE_CURRENT_BINARY_DIR}/generated/digit_atlas.c)
+    set(digit_atlas_font ${ZEPHYR_LVGL_MODULE_DIR}/src/font/lv_font_montserrat_46.c)
+    add_custom_command(
+        OUTPUT ${digit_atlas}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${CMAKE_CURRENT_BINARY_DIR}/generated
+        COMMAND ${PYTHON_EXECUTABLE} ${ZEPHYRWATCH_ROOT}/scripts/generate_digit_atlas.py
+                --font ${digit_atlas_font}
+                --foreground FFFFFF
+                --background 000000
+                --output ${digit_atlas}
+        DEPENDS ${ZEPHYRWATCH_ROOT}/scripts/generate_digit_atlas.py ${digit_atlas_font}
+        COMMENT "Generating clock digit atlas"
+        VERBATIM)
+    target_sources(${target} PRIVATE ${digit_atlas})
+endfunction()
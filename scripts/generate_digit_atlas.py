@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Clock digit atlas generator for ZephyrWatch.
+
+Pre-renders the glyphs of the home screen clock ('0'-'9' and ':') from an LVGL font source into
+RGB565 images, so the clock is blitted from flash instead of rasterized by the font engine. The
+font source is the one shipped with LVGL (e.g. src/font/lv_font_montserrat_46.c), which is not
+compiled into the image anymore.
+
+@license GNU v3
+@maintainer electricalgorithm @ github
+"""
+
+import argparse
+import re
+
+GLYPHS = "0123456789:"
+
+# The size of lv_font_fmt_txt_glyph_dsc_t, with LV_FONT_FMT_TXT_LARGE disabled.
+GLYPH_DSC_SIZE = 8
+
+
+def parse_int(source: str, field: str) -> int:
+    """Return the value of the first `.field = value` initializer."""
+    match = re.search(rf"\.{field}\s*=\s*(-?\d+)", source)
+    if not match:
+        raise ValueError(f"Font field {field} is not found.")
+    return int(match.group(1))
+
+
+def parse_font(source: str):
+    """Return the bitmap, the glyph descriptors, the cmaps and the metrics of an LVGL font source."""
+    if parse_int(source, "bpp") != 4 or parse_int(source, "bitmap_format") != 0:
+        raise ValueError("Only uncompressed 4 bpp fonts are supported.")
+
+    body = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", source, re.S).group(1)
+    body = re.sub(r"/\*.*?\*/", "", body, flags=re.S)
+    bitmap = [int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]+", body)]
+
+    glyphs = [tuple(int(value) for value in match) for match in re.findall(
+        r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+        r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}", source)]
+
+    cmaps = [tuple(int(value) for value in match[:3]) + (match[3],) for match in re.findall(
+        r"\.range_start = (\d+), \.range_length = (\d+), \.glyph_id_start = (\d+),.*?"
+        r"\.type = (LV_FONT_FMT_TXT_CMAP_\w+)", source, re.S)]
+
+    return bitmap, glyphs, cmaps, parse_int(source, "line_height"), parse_int(source, "base_line")
+
+
+def array_length(source: str, name: str) -> int:
+    """Return the number of initializers of the array, or 0 if the font does not have it."""
+    match = re.search(rf"\b{name}\[\]\s*=\s*\{{(.*?)\}};", source, re.S)
+    if not match:
+        return 0
+    body = re.sub(r"/\*.*?\*/", "", match.group(1), flags=re.S)
+    return len(re.findall(r"-?(?:0x[0-9a-fA-F]+|\d+)", body))
+
+
+def font_size(source: str) -> dict:
+    """Return the bytes of the font's bitmap, glyph descriptor and kerning tables in flash."""
+    glyph_count = len(re.findall(r"\{\.bitmap_index = \d+", source))
+    return {
+        "bitmap": array_length(source, "glyph_bitmap"),
+        "glyphs": glyph_count * GLYPH_DSC_SIZE,
+        "kerning": sum(array_length(source, name) for name in (
+            "kern_left_class_mapping", "kern_right_class_mapping", "kern_class_values")),
+    }
+
+
+def glyph_id(cmaps, codepoint: int) -> int:
+    """Return the glyph id of the code point from the continuous cmaps."""
+    for start, length, id_start, kind in cmaps:
+        if start <= codepoint < start + length:
+            if kind != "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY":
+                raise ValueError(f"Code point {codepoint} is in an unsupported {kind} cmap.")
+            return id_start + codepoint - start
+    raise ValueError(f"Code point {codepoint} is not in the font.")
+
+
+def glyph_alpha(bitmap, glyph):
+    """Unpack the 4 bpp glyph bitmap. The rows are packed continuously, without byte alignment."""
+    index, _, width, height, _, _ = glyph
+    alpha = []
+    for pixel in range(width * height):
+        byte = bitmap[index + pixel // 2]
+        nibble = (byte >> 4) if pixel % 2 == 0 else (byte & 0x0F)
+        alpha.append(nibble * 17)
+    return alpha
+
+
+def to_rgb565(foreground, background, alpha: int) -> int:
+    """Blend the colors with the alpha, and convert the result to RGB565."""
+    red, green, blue = (
+        (fg * alpha + bg * (255 - alpha) + 127) // 255 for fg, bg in zip(foreground, background))
+    return ((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3)
+
+
+def parse_color(value: str):
+    value = int(value, 16)
+    return (value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF
+
+
+def generate(source: str, foreground, background) -> str:
+    bitmap, glyph_dscs, cmaps, line_height, base_line = parse_font(source)
+    glyphs = [glyph_dscs[glyph_id(cmaps, ord(character))] for character in GLYPHS]
+
+    # Each image is as tall as the union of the glyph boxes, aligned at the base line.
+    tops = [line_height - base_line - glyph[3] - glyph[5] for glyph in glyphs]
+    bottoms = [line_height - base_line - glyph[5] for glyph in glyphs]
+    top, height = min(tops), max(bottoms) - min(tops)
+
+    # The digits share the width of the widest digit, so the cells never resize.
+    advances = [(glyph[1] + 15) // 16 for glyph in glyphs]
+    digit_width = max(advances[:10])
+
+    pixels = []
+    images = []
+    for character, glyph, advance in zip(GLYPHS, glyphs, advances):
+        width = advance if character == ":" else digit_width
+        image = [to_rgb565(foreground, background, 0)] * (width * height)
+        alpha = glyph_alpha(bitmap, glyph)
+        _, _, box_w, box_h, ofs_x, ofs_y = glyph
+        left = ofs_x + (width - advance) // 2
+        box_top = line_height - base_line - box_h - ofs_y - top
+        for y in range(box_h):
+            for x in range(box_w):
+                if 0 <= left + x < width and 0 <= box_top + y < height:
+                    image[(box_top + y) * width + left + x] = to_rgb565(
+                        foreground, background, alpha[y * box_w + x])
+        images.append((character, len(pixels), width))
+        pixels.extend(image)
+
+    lines = [
+        "/** Clock digit atlas for ZephyrWatch.",
+        " * Generated by scripts/generate_digit_atlas.py, do not edit.",
+        f" * {len(GLYPHS)} glyphs of {height} px height in RGB565, {len(pixels) * 2} bytes.",
+        " */",
+        "",
+        '#include "userinterface/widgets/digitclock/digitatlas.h"',
+        "",
+        "static const uint16_t digit_atlas_pixels[] = {",
+    ]
+    for row in range(0, len(pixels), 12):
+        lines.append("    " + " ".join(f"0x{pixel:04x}," for pixel in pixels[row:row + 12]))
+    lines.append("};")
+    lines.append("")
+    lines.append("const lv_image_dsc_t digit_atlas[DIGIT_ATLAS_GLYPH_COUNT] = {")
+    for character, offset, width in images:
+        lines.append(f"    /* '{character}' */ {{")
+        lines.append("        .header.magic = LV_IMAGE_HEADER_MAGIC,")
+        lines.append("        .header.cf = LV_COLOR_FORMAT_RGB565,")
+        lines.append(f"        .header.w = {width},")
+        lines.append(f"        .header.h = {height},")
+        lines.append(f"        .header.stride = {width * 2},")
+        lines.append(f"        .data_size = {width * height * 2},")
+        lines.append(f"        .data = (const uint8_t *)&digit_atlas_pixels[{offset}],")
+        lines.append("    },")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--font", required=True, help="LVGL font source, e.g. lv_font_montserrat_46.c.")
+    parser.add_argument("--foreground", default="FFFFFF", help="Text color as RRGGBB.")
+    parser.add_argument("--background", default="000000", help="Background color as RRGGBB.")
+    parser.add_argument("--output", required=True)
+    args = parser.parse_args()
+
+    with open(args.font, encoding="utf-8") as font:
+        source = font.read()
+    content = generate(source, parse_color(args.foreground), parse_color(args.background))
+    with open(args.output, "w", encoding="utf-8") as output:
+        output.write(content)
+
+    # The flash the atlas saves, printed with the build.
+    atlas_size = int(re.search(r"RGB565, (\d+) bytes", content).group(1))
+    sizes = font_size(source)
+    font_total = sum(sizes.values())
+    print(f"Digit atlas is {atlas_size} bytes. The font it replaces is {font_total} bytes: "
+          f"{sizes['bitmap']} bytes of bitmap, {sizes['glyphs']} bytes of glyph descriptors and "
+          f"{sizes['kerning']} bytes of kerning. The atlas saves {font_total - atlas_size} bytes.")
+
+
+if __name__ == "__main__":
+    main()
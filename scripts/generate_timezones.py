@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Time zone table generator for ZephyrWatch.
+
+Generates a compact C table of UTC offset transitions for the selected time zones from the tz
+database of the build host. The table is consumed by the timezone module of the datetime subsystem.
+
+@license GNU v3
+@maintainer electricalgorithm @ github
+"""
+
+import argparse
+import re
+from datetime import datetime, timezone
+from zoneinfo import ZoneInfo
+
+SECONDS_PER_DAY = 86400
+
+
+def offset_minutes(zone: ZoneInfo, timestamp: int) -> int:
+    """Return the UTC offset of the zone at the given UNIX time in minutes."""
+    offset = datetime.fromtimestamp(timestamp, zone).utcoffset().total_seconds()
+    if offset % 60:
+        raise ValueError(f"{zone.key} has a sub-minute offset at {timestamp}.")
+    return int(offset // 60)
+
+
+def find_transitions(name: str, start_year: int, end_year: int):
+    """Return the offset before the range and the (time, offset) transitions inside the range."""
+    zone = ZoneInfo(name)
+    start = int(datetime(start_year, 1, 1, tzinfo=timezone.utc).timestamp())
+    end = int(datetime(end_year + 1, 1, 1, tzinfo=timezone.utc).timestamp())
+
+    initial_offset = offset_minutes(zone, start)
+    previous_offset = initial_offset
+    transitions = []
+
+    # Scan day by day, and bisect the exact second of each offset change.
+    for day_start in range(start + SECONDS_PER_DAY, end + SECONDS_PER_DAY, SECONDS_PER_DAY):
+        day_start = min(day_start, end)
+        offset = offset_minutes(zone, day_start)
+        if offset == previous_offset:
+            continue
+        low, high = day_start - SECONDS_PER_DAY, day_start
+        while high - low > 1:
+            middle = (low + high) // 2
+            if offset_minutes(zone, middle) == previous_offset:
+                low = middle
+            else:
+                high = middle
+        transitions.append((high, offset))
+        previous_offset = offset
+
+    return initial_offset, transitions
+
+
+def to_identifier(name: str) -> str:
+    """Convert a zone name to a C identifier."""
+    return "tz_" + re.sub(r"[^0-9A-Za-z]", "_", name).lower()
+
+
+def generate(zones, start_year: int, end_year: int) -> str:
+    lines = [
+        "/** Time zone transition table for ZephyrWatch.",
+        " * Generated by scripts/generate_timezones.py, do not edit.",
+        f" * Covers the years {start_year}-{end_year}.",
+        " */",
+        "",
+        '#include "datetime/timezone.h"',
+        "",
+    ]
+    rules = []
+    for name in zones:
+        initial_offset, transitions = find_transitions(name, start_year, end_year)
+        identifier = to_identifier(name)
+        if transitions:
+            lines.append(f"static const timezone_transition_t {identifier}[] = {{")
+            for timestamp, offset in transitions:
+                lines.append(f"    {{ {timestamp}U, {offset} }},")
+            lines.append("};")
+            lines.append("")
+            rules.append(f'    {{ "{name}", {initial_offset}, {identifier}, ARRAY_SIZE({identifier}) }},')
+        else:
+            rules.append(f'    {{ "{name}", {initial_offset}, NULL, 0 }},')
+
+    lines.append("const timezone_rule_t timezone_rules[] = {")
+    lines.extend(rules)
+    lines.append("};")
+    lines.append("")
+    lines.append("const uint8_t timezone_rule_count = ARRAY_SIZE(timezone_rules);")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zones", required=True, help="Semicolon separated list of tz database names.")
+    parser.add_argument("--start-year", type=int, default=2020)
+    parser.add_argument("--end-year", type=int, default=2060)
+    parser.add_argument("--output", required=True)
+    args = parser.parse_args()
+
+    zones = [zone for zone in args.zones.split(";") if zone]
+    if not zones or len(zones) > 255:
+        parser.error("Between 1 and 255 zones must be selected.")
+
+    content = generate(zones, args.start_year, args.end_year)
+    with open(args.output, "w", encoding="utf-8") as output:
+        output.write(content)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,42 @@
+/** Benchmark Clock for ZephyrWatch.
+ * Measures short durations with the cycle counter, or with the host's monotonic clock on native_sim.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <zephyr/kernel.h>
+
+#include "benchmark/benchmarkclock.h"
+
+#if defined(CONFIG_ARCH_POSIX)
+#if !defined(CONFIG_EXTERNAL_LIBC)
+#error "The benchmark clock reads the host's clock on native_sim, enable CONFIG_EXTERNAL_LIBC."
+#endif
+#include <time.h>
+#endif
+
+/* BENCHMARK_CLOCK_START
+ * Return the host's monotonic time in nanoseconds on native_sim, and the cycle counter elsewhere.
+ */
+benchmark_clock_t benchmark_clock_start() {
+#if defined(CONFIG_ARCH_POSIX)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+#else
+    return k_cycle_get_32();
+#endif
+}
+
+/* BENCHMARK_CLOCK_ELAPSED_NS
+ * Return the nanoseconds since the start. The cycles are subtracted in 32 bits, so a wrap of the
+ * counter in between is harmless.
+ */
+uint64_t benchmark_clock_elapsed_ns(benchmark_clock_t start) {
+#if defined(CONFIG_ARCH_POSIX)
+    return benchmark_clock_start() - start;
+#else
+    return k_cyc_to_ns_floor64(k_cycle_get_32() - (uint32_t)start);
+#endif
+}
@@ -0,0 +1,33 @@
+/** Benchmark Clock for ZephyrWatch.
+ * Measures short durations for the benchmarks and the boot-time statistics. On the watch it counts
+ * the hardware cycles. native_sim runs the code in no simulated time, so there it reads the host's
+ * monotonic clock, which needs CONFIG_EXTERNAL_LIBC.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _BENCHMARK_BENCHMARKCLOCK_H
+#define _BENCHMARK_BENCHMARKCLOCK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint64_t benchmark_clock_t;
+
+/* Start a measurement. */
+benchmark_clock_t benchmark_clock_start();
+
+/* Return the nanoseconds since the start. On the watch the measurement must be shorter than a wrap
+ * of the 32-bit cycle counter, i.e. about 17 seconds at 240 MHz.
+ */
+uint64_t benchmark_clock_elapsed_ns(benchmark_clock_t start);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
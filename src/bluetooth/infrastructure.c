@@ -5,7 +5,7 @@
  * @maintainer: electricalgorithm @ github 
  */
 
-#include "userinterface/screens/blepairing/blepairing.h"
+#include "userinterface/uicommand.h"
 #include "zephyr/bluetooth/conn.h"
 #include <zephyr/settings/settings.h>
 #include <zephyr/bluetooth/gatt.h>
@@ -58,10 +58,8 @@ char* passkey_to_string(const unsigned int passkey) {
 
 static void process_passkey_display(struct bt_conn *conn, unsigned int passkey){
     char addr[BT_ADDR_LE_STR_LEN] = {0};
-    // Write PIN to the screen.
-    blepairing_screen_init();
-    blepairing_screen_set_pin(passkey_to_string(passkey));
-    blepairing_screen_load();
+    // Write PIN to the screen. The screen is built by the UI thread.
+    ui_command_post_show_pairing(passkey_to_string(passkey));
     LOG_DBG("Displaying passkey on the screen.");
 
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
@@ -72,18 +70,18 @@ static void process_auth_cancel(struct bt_conn *conn){
     char addr[BT_ADDR_LE_STR_LEN];
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
     LOG_DBG("Pairing cancelled: %s", addr);
-    blepairing_screen_unload();
+    ui_command_post_hide_pairing();
 }
 
 static void process_pairing_complete(struct bt_conn *conn, bool bonded) {
     LOG_DBG("Pairing complete. Bonded: %s", bonded ? "OK" : "FAILURE");
-    blepairing_screen_unload();
+    ui_command_post_hide_pairing();
 }
 
 static void process_pairing_failed(struct bt_conn *conn, enum bt_security_err reason) {
     LOG_DBG("Pairing failed. Reason: 0x%02x", reason);
     bt_conn_disconnect(conn, BT_HCI_ERR_AUTH_FAIL);
-    blepairing_screen_unload();
+    ui_command_post_hide_pairing();
 }
 
 static struct bt_conn_auth_info_cb auth_info_callbacks = {
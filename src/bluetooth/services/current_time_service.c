@@ -12,6 +12,8 @@
 
 #include "current_time_service.h"
 #include "datetime/datetime.h"
+#include "datetime/drift.h"
+#include "datetime/timezone.h"
 #include "devicetwin/devicetwin.h"
 
 LOG_MODULE_REGISTER(ZephyrWatch_BLE_CTS, LOG_LEVEL_INF);
@@ -35,21 +37,24 @@ static ssize_t m_time_write_callback(
     uint32_t unix_timestamp = sys_le32_to_cpu(*(uint32_t *)buf);
     LOG_DBG("Received UNIX timestamp: %u", unix_timestamp);
 
-    // Get the device twin instance to get the UTC zone
-    device_twin_t *device_twin = get_device_twin_instance();
-    if (device_twin == NULL) {
+    // Get the device twin instance to get the time zone
+    device_twin_t device_twin;
+    if (device_twin_snapshot(&device_twin)) {
         LOG_ERR("Failed to get device twin instance.");
         return BT_GATT_ERR(BT_ATT_ERR_UNLIKELY);
     }
-    device_twin->unix_time = unix_timestamp;
-    trigger_ui_update();
 
-    // Convert UNIX timestamp to local time using the device's UTC zone to print.
-    datetime_t local_time = unix_to_localtime(unix_timestamp, device_twin->utc_zone);
-    LOG_INF("Current time updated to local time: %04d-%02d-%02d %02d:%02d:%02d (UTC%+d)", 
+    // Learn the drift of the device clock before correcting it.
+    drift_process_sync(get_current_unix_time_ms(), (int64_t)unix_timestamp * MSEC_PER_SEC);
+    set_current_unix_time(unix_timestamp);
+
+    // Convert UNIX timestamp to local time using the device's time zone to print.
+    int16_t utc_offset_minutes = timezone_get_offset_minutes(device_twin.timezone_id, unix_timestamp);
+    datetime_t local_time = unix_to_localtime(unix_timestamp, utc_offset_minutes);
+    LOG_INF("Current time updated to local time: %04d-%02d-%02d %02d:%02d:%02d (%s, UTC%+d min)",
         local_time.year, local_time.month, local_time.day,
         local_time.hour, local_time.minute, local_time.second,
-        device_twin->utc_zone);
+        timezone_get_name(device_twin.timezone_id), utc_offset_minutes);
 
     return len;
 }
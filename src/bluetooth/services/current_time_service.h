@@ -16,9 +16,6 @@ extern "C" {
 #include <zephyr/logging/log.h>
 #include <zephyr/bluetooth/gatt.h>
 
-/* A function to trigger UI updates - to be implemented in main.c */
-extern void trigger_ui_update();
-
 #ifdef __cplusplus
 }
 #endif
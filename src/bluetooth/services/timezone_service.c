@@ -0,0 +1,85 @@
+/** Time Zone Service implementation for selecting the device's time zone via Bluetooth GATT.
+ * The client reads and writes the tz database name of the time zone, e.g. "Europe/Berlin".
+ *
+ * @license: GNU v3 
+ * @maintainer: electricalgorithm @ github
+ */
+
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <string.h>
+
+#include "timezone_service.h"
+#include "datetime/timezone.h"
+#include "devicetwin/devicetwin.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_BLE_Timezone, LOG_LEVEL_INF);
+
+// The longest name in the tz database is shorter than this.
+#define TIMEZONE_NAME_MAX_LEN 32
+
+static const struct bt_uuid_128 timezone_service_uuid = BT_UUID_INIT_128(BT_UUID_TIMEZONE_SERVICE_VAL);
+static const struct bt_uuid_128 timezone_name_uuid = BT_UUID_INIT_128(BT_UUID_TIMEZONE_NAME_VAL);
+
+/* Time Zone Name Read Callback */
+static ssize_t m_timezone_read_callback(
+    struct bt_conn *conn,
+    const struct bt_gatt_attr *attr,
+    void *buf,
+    uint16_t len,
+    uint16_t offset) {
+
+    device_twin_t device_twin;
+    if (device_twin_snapshot(&device_twin)) {
+        LOG_ERR("Failed to get device twin instance.");
+        return BT_GATT_ERR(BT_ATT_ERR_UNLIKELY);
+    }
+
+    const char *name = timezone_get_name(device_twin.timezone_id);
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, name, strlen(name));
+}
+
+/* Time Zone Name Write Callback */
+static ssize_t m_timezone_write_callback(
+    struct bt_conn *conn,
+    const struct bt_gatt_attr *attr,
+    const void *buf,
+    uint16_t len,
+    uint16_t offset,
+    uint8_t flags) {
+
+    // Check if we received the whole name at once.
+    if (offset != 0 || len == 0 || len >= TIMEZONE_NAME_MAX_LEN) {
+        LOG_ERR("Invalid write length or offset. Got %d bytes at offset %d", len, offset);
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    // Copy the name to terminate it.
+    char name[TIMEZONE_NAME_MAX_LEN];
+    memcpy(name, buf, len);
+    name[len] = '\0';
+
+    int timezone_id = timezone_find(name);
+    if (timezone_id < 0) {
+        LOG_ERR("Time zone %s is not supported.", name);
+        return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+    }
+
+    if (device_twin_set_timezone_id((uint8_t)timezone_id)) {
+        LOG_ERR("Failed to get device twin instance.");
+        return BT_GATT_ERR(BT_ATT_ERR_UNLIKELY);
+    }
+
+    LOG_INF("Time zone updated to %s.", name);
+    return len;
+}
+
+/* Time Zone Service Declaration */
+BT_GATT_SERVICE_DEFINE(timezone_svc,
+    BT_GATT_PRIMARY_SERVICE(&timezone_service_uuid),
+    BT_GATT_CHARACTERISTIC(
+        &timezone_name_uuid.uuid,
+        BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE,
+        BT_GATT_PERM_READ | BT_GATT_PERM_WRITE_ENCRYPT | BT_GATT_PERM_WRITE_AUTHEN,
+        m_timezone_read_callback, m_timezone_write_callback, NULL),
+);
@@ -0,0 +1,29 @@
+/** Time Zone Service implementation for selecting the device's time zone via Bluetooth GATT.
+ * The client reads and writes the tz database name of the time zone, e.g. "Europe/Berlin".
+ *
+ * @license: GNU v3 
+ * @maintainer: electricalgorithm @ github
+ */
+
+#ifndef TIMEZONE_SERVICE_H
+#define TIMEZONE_SERVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/bluetooth/gatt.h>
+
+/* Time Zone Service UUID: 7a1e0001-5c3b-4f1e-9d1a-6b2e3c4d5e6f */
+#define BT_UUID_TIMEZONE_SERVICE_VAL \
+    BT_UUID_128_ENCODE(0x7a1e0001, 0x5c3b, 0x4f1e, 0x9d1a, 0x6b2e3c4d5e6f)
+
+/* Time Zone Name Characteristic UUID: 7a1e0002-5c3b-4f1e-9d1a-6b2e3c4d5e6f */
+#define BT_UUID_TIMEZONE_NAME_VAL \
+    BT_UUID_128_ENCODE(0x7a1e0002, 0x5c3b, 0x4f1e, 0x9d1a, 0x6b2e3c4d5e6f)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMEZONE_SERVICE_H
@@ -12,83 +12,63 @@
 
 #include "devicetwin/devicetwin.h"
 #include "datetime/datetime.h"
+#include "datetime/drift.h"
+#include "datetime/scheduler.h"
+#include "datetime/timezone.h"
 
 // Get devices from the device tree.
 #define RTC_COUNTER_DEVICE DT_ALIAS(rtccounterdevice)
 
-// Configuration for counter alarm.
-#define ALARM_INTERVAL_US 1000000
-#define ALARM_CHANNEL_ID 0
-
 /* Register a logger for this library. */
 LOG_MODULE_REGISTER(ZephyrWatch_Datetime, LOG_LEVEL_INF);
 
-/* Disable flag to not set alarm again in ISR.
- * 0: Set alarm again.
- * !: Do not set alarm again.
+/* The time is not counted with periodic interrupts. Instead, the time base keeps the UNIX time at
+ * the last counter snapshot, and the time is computed on demand by adding the counter ticks elapsed
+ * since then. Each read moves the snapshot forward, so the counter wraparound is handled as long as
+ * the time is read at least once per wrap period (hours for the ESP32 RTC counter).
  */
-static uint8_t reset_alarm = 0;
-
-/* Global alarm configuration structure - must persist for ISR access */
-static struct counter_alarm_cfg alarm_cfg;
+static const struct device *real_time_counter = DEVICE_DT_GET(RTC_COUNTER_DEVICE);
+static struct k_spinlock time_base_lock;
+static int64_t base_time_us = 0;        // UNIX time in microseconds at the counter snapshot.
+static uint32_t counter_snapshot = 0;   // Counter value at the last read.
+static bool time_base_running = false;  // The counter is started and the snapshot is valid.
 
 /* Prototype definition of internal static functions and variables */
-static const uint16_t days_in_month[] = {
-    31, 28, 31, 30, 31, 30,
-    31, 31, 30, 31, 30, 31
-};
+static int64_t floor_div(int64_t value, int64_t divisor);
+static uint8_t calc_weekday(int64_t days_since_epoch);
+static void days_to_civil(int64_t days_since_epoch, datetime_t *datetime);
 static bool is_leap_year(uint16_t year);
-static uint8_t calc_weekday(uint32_t days_since_epoch);
+static uint8_t calc_days_in_month(uint16_t year, uint8_t month);
+static void advance_one_day(datetime_t *datetime);
+static int64_t update_time_base();
 
-/* Since our board's RTC is not an real-time clock but a real-time counter,
- * we do get a drift in the time as 4 minutes per hour. It means 0.06 seconds drift per each second,
- * and we need to resolve it as much as we can. Within this drift code, we aim to add extra 1 second
- * (DRIFT_CORRECTION_SECONDS) for each 15 seconds (DRIFT_DETECTION_SECONDS).
- *
- * We store the last time we applied drift to last_drift variable and check if 60 seconds passed
- * in each RTC ISR call. When drift is applied, we update the last_drift to wait the next 60 secs.
+/* Calendar tables for the days-to-civil conversion. The year is shifted to start at March, so the
+ * leap day becomes the last day of the year and every month start is a fixed offset from March 1st.
  */
-#define DRIFT_DETECTION_SECONDS 15
-#define DRIFT_CORRECTION_SECONDS 1
-static uint32_t last_drift = 0;
+static const uint16_t days_before_shifted_month[12] = {
+    0, 31, 61, 92, 122, 153, 184, 214, 245, 275, 306, 337
+};
+static const uint8_t shifted_month_to_civil[12] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 1, 2
+};
+static const uint8_t days_in_month[12] = {
+    31, 28, 31, 30, 31, 30,
+    31, 31, 30, 31, 30, 31
+};
 
-/* RTC_ISR
- * Interrupt service routine for alarm with real-time counters.  This ISR is executed every
- * seconds. The user_data is an counter_alarm_cfg object. It updates static unix_time variable.
+/* The largest step a cursor is advanced with carries. Bigger steps are treated as a time jump, and
+ * the cursor is recomputed. It must stay below a day, so at most one day carry is applied.
  */
-void rtc_isr(const struct device *dev, uint8_t channel_id, uint32_t ticks, void *user_data) {
-    // Cast alarm config from user data.
-    struct counter_alarm_cfg *alarm_cfg = user_data;
-
-    // Reset alarm if flag is set.
-    if (!reset_alarm) {
-        alarm_cfg->ticks = counter_us_to_ticks(dev, ALARM_INTERVAL_US);
-        counter_set_channel_alarm(dev, ALARM_CHANNEL_ID, alarm_cfg);
-    }
-
-    // Get device's current time.
-    uint32_t current_unix_time = get_current_unix_time();
-    uint8_t update_amount = 1;  // Always +1 since ISR called every second.
-
-    // Apply a manual drift correction to the time.
-    if (current_unix_time - last_drift >= DRIFT_DETECTION_SECONDS) {
-        update_amount += DRIFT_CORRECTION_SECONDS;
-        last_drift = current_unix_time + update_amount;
-    }
-
-    // Update the system time.
-    set_current_unix_time(current_unix_time + update_amount);
-}
+#define CURSOR_MAX_ADVANCE_SECONDS 3600
 
 /* ENABLE_DATETIME_SUBSYSTEM
- * This function sets the soft real-time clock to track the time. It implements the counters
- * with one second alarm to update a global variable. 
+ * This function starts the real-time counter to track the time. The time base starts from the
+ * device twin's time.
  */
 int enable_datetime_subsystem() {
     int ret;
 
-    // Set the real time counter to trigger an callback every second.
-    const struct device *real_time_counter = DEVICE_DT_GET(RTC_COUNTER_DEVICE);
+    // Check the real time counter to be used as the time base.
     if (!device_is_ready(real_time_counter)) {
         LOG_ERR("Real time counter device is not ready.");
         return -ENODEV;
@@ -103,39 +83,45 @@ int enable_datetime_subsystem() {
     }
     LOG_DBG("Real time counter started successfully.");
 
-    // Configure the global alarm structure.
-    alarm_cfg.flags = 0;
-    alarm_cfg.ticks = counter_us_to_ticks(real_time_counter, ALARM_INTERVAL_US);
-    alarm_cfg.callback = rtc_isr;
-    alarm_cfg.user_data = &alarm_cfg;
-
-    ret = counter_set_channel_alarm(real_time_counter, ALARM_CHANNEL_ID, &alarm_cfg);
-    if (ret) {
-        LOG_ERR("Failed to set channel alarm (ret %d).", ret);
-        return ret;
+    // Take the first snapshot of the time base.
+    device_twin_t device_twin;
+    device_twin_snapshot(&device_twin);
+    K_SPINLOCK(&time_base_lock) {
+        base_time_us = device_twin.unix_time_ms * USEC_PER_MSEC;
+        counter_get_value(real_time_counter, &counter_snapshot);
+        time_base_running = true;
     }
-    LOG_DBG("Channel alarm set successfully.");
+    LOG_DBG("Time base snapshot is taken.");
 
     return 0;
 }
 
 /* DISABLE_DATETIME_SUBSYSTEM
- * Stops the real-time counter and its alarm to disable the datetime subsystem.
+ * Stops the real-time counter to disable the datetime subsystem. The time is frozen at its last
+ * value until the subsystem is enabled again.
  */
 int disable_datetime_subsystem() {
     int ret;
 
-    // Set the real time counter to trigger an callback every second.
-    const struct device *real_time_counter = DEVICE_DT_GET(RTC_COUNTER_DEVICE);
+    // Check the real time counter to be stopped.
     if (!device_is_ready(real_time_counter)) {
         LOG_ERR("Real time counter device is not ready.");
         return -ENODEV;
     }
     LOG_DBG("Real time counter device is ready.");
 
-    // Disable the alarm first.
-    reset_alarm = 1;
-    LOG_DBG("Reset flag is cleared.");
+    // Freeze the time base with a last snapshot, and keep it in the device twin to start from it.
+    int64_t unix_time_ms = floor_div(update_time_base(), USEC_PER_MSEC);
+    K_SPINLOCK(&time_base_lock) {
+        time_base_running = false;
+    }
+    k_spinlock_key_t key;
+    device_twin_t *device_twin = device_twin_write_begin(&key);
+    if (device_twin) {
+        device_twin->unix_time_ms = unix_time_ms;
+    }
+    device_twin_write_commit(key, 0);
+    LOG_DBG("Time base is frozen.");
 
     // Stop real time counter to track tine.
     ret = counter_stop(real_time_counter);
@@ -149,77 +135,135 @@ int disable_datetime_subsystem() {
 }
 
 /* GET_CURRENT_UNIX_TIME
- * Return the UNIX epochs of the current time.
+ * Return the UNIX epochs of the current time. It is a view of the millisecond time, which is
+ * valid until 2106.
  */
 uint32_t get_current_unix_time() {
-    device_twin_t *device_twin = get_device_twin_instance();
-    return device_twin->unix_time;
+    return (uint32_t)floor_div(get_current_unix_time_ms(), MSEC_PER_SEC);
 }
 
 /* SET_CURRENT_UNIX_TIME
  * Set the current time with UNIX epoch.
  */
 int set_current_unix_time(uint32_t new_time) {
+    return set_current_unix_time_ms((int64_t)new_time * MSEC_PER_SEC);
+}
+
+/* GET_CURRENT_UNIX_TIME_MS
+ * Return the milliseconds since UNIX epoch of the current time.
+ */
+int64_t get_current_unix_time_ms() {
+    return floor_div(update_time_base(), USEC_PER_MSEC);
+}
+
+/* SET_CURRENT_UNIX_TIME_MS
+ * Set the current time with milliseconds since UNIX epoch.
+ */
+int set_current_unix_time_ms(int64_t new_time_ms) {
+    // Restart the time base from the new time.
+    K_SPINLOCK(&time_base_lock) {
+        base_time_us = new_time_ms * USEC_PER_MSEC;
+        if (time_base_running) {
+            counter_get_value(real_time_counter, &counter_snapshot);
+        }
+    }
+
     // Update the system time.
-    device_twin_t *device_twin = get_device_twin_instance();
-    device_twin->unix_time = new_time;
+    device_twin_set_unix_time_ms(new_time_ms);
+
+    // The deadlines of the scheduled events are moved relative to the new time.
+    wallclock_reschedule();
+    return 0;
+}
+
+/* GET_TIME_BASE_SNAPSHOT
+ * Return a consistent pair of the UNIX time and the counter value it belongs to. The pair is kept
+ * across resets to restore the time later.
+ */
+void get_time_base_snapshot(int64_t *unix_time_ms, uint32_t *counter_value) {
+    update_time_base();
+    K_SPINLOCK(&time_base_lock) {
+        *unix_time_ms = floor_div(base_time_us, USEC_PER_MSEC);
+        *counter_value = counter_snapshot;
+    }
+}
+
+/* RESTORE_TIME_BASE_SNAPSHOT
+ * Restore the time from a snapshot taken before a reset. The ESP32 RTC counter keeps running over
+ * the watchdog and software resets, so if the counter is still ahead of the snapshot, the ticks
+ * elapsed since then are added by the next read. Otherwise, the counter is restarted (e.g. a power
+ * cycle), and the time continues from the snapshot as the best known time.
+ */
+int restore_time_base_snapshot(int64_t unix_time_ms, uint32_t counter_value) {
+    bool elapsed_restored = false;
+
+    K_SPINLOCK(&time_base_lock) {
+        base_time_us = unix_time_ms * USEC_PER_MSEC;
+        if (time_base_running) {
+            uint32_t now;
+            counter_get_value(real_time_counter, &now);
+            if (now >= counter_value) {
+                counter_snapshot = counter_value;
+                elapsed_restored = true;
+            } else {
+                counter_snapshot = now;
+            }
+        }
+    }
+    LOG_INF("Time base is restored %s the elapsed counter ticks.",
+            elapsed_restored ? "with" : "without");
+
+    // Update the system time, which also accounts the elapsed ticks.
+    device_twin_set_unix_time_ms(floor_div(update_time_base(), USEC_PER_MSEC));
+    wallclock_reschedule();
     return 0;
 }
 
 /* GET_CURRENT_LOCAL_TIME
- * Return the current time in datetime_t object in local time zone.
+ * Return the current time in datetime_t object in the given time zone.
+ */
+datetime_t get_current_local_time(uint8_t timezone_id) {
+    int64_t unix_time_ms = get_current_unix_time_ms();
+    int16_t utc_offset_minutes = timezone_get_offset_minutes(timezone_id,
+                                                             floor_div(unix_time_ms, MSEC_PER_SEC));
+    return unix_ms_to_localtime(unix_time_ms, utc_offset_minutes);
+}
+
+/* UNIX_MS_TO_LOCALTIME
+ * Converts Unix time in milliseconds to local time using UTC offset in minutes.
  */
-datetime_t get_current_local_time(int8_t utc_offset_hours) {
-    return unix_to_localtime(get_current_unix_time(), utc_offset_hours);
+datetime_t unix_ms_to_localtime(int64_t timestamp_ms, int16_t utc_offset_minutes) {
+    int64_t seconds = floor_div(timestamp_ms, MSEC_PER_SEC);
+    datetime_t local = unix_to_localtime(seconds, utc_offset_minutes);
+    local.millisecond = (uint16_t)(timestamp_ms - seconds * MSEC_PER_SEC);
+    return local;
 }
 
 /* UNIX_TO_LOCALTIME
- * Converts Unix time to local time using UTC offset in hours (e.g., +2 or -5)
+ * Converts Unix time to local time using UTC offset in minutes (e.g., +120 or -300). It runs in constant
+ * time regardless of the year, and handles timestamps before 1970 as well. The year field limits
+ * the range to 0000-65535.
  */
-datetime_t unix_to_localtime(int32_t timestamp, int8_t utc_offset_hours) {
+datetime_t unix_to_localtime(int64_t timestamp, int16_t utc_offset_minutes) {
     datetime_t utc;
 
-    // Apply time zone offset
-    int32_t adjusted = timestamp + (utc_offset_hours * 3600);
-
-    // Handle negative timestamps (before 1970)
-    if (adjusted < 0) {
-        // Optional: clamp or handle negative time
-        adjusted = 0;
-    }
+    // Apply time zone offset.
+    int64_t adjusted = timestamp + (utc_offset_minutes * 60);
 
-    uint32_t seconds = (uint32_t)adjusted;
+    // Split into days and seconds of the day with floor division to support negative times.
+    int64_t days = floor_div(adjusted, 86400);
+    uint32_t seconds = (uint32_t)(adjusted - days * 86400);
 
     // Time part
+    utc.millisecond = 0;
     utc.second = seconds % 60;
     seconds /= 60;
     utc.minute = seconds % 60;
-    seconds /= 60;
-    utc.hour = seconds % 24;
-    uint32_t days = seconds / 24;
-
-    utc.weekday = calc_weekday(days);
+    utc.hour = seconds / 60;
 
     // Date part
-    uint16_t year = 1970;
-    while (1) {
-        uint16_t days_in_year = is_leap_year(year) ? 366 : 365;
-        if (days < days_in_year) break;
-        days -= days_in_year;
-        year++;
-    }
-    utc.year = year;
-
-    uint8_t month = 0;
-    while (1) {
-        uint16_t dim = days_in_month[month];
-        if (month == 1 && is_leap_year(year)) dim++;
-        if (days < dim) break;
-        days -= dim;
-        month++;
-    }
-    utc.month = month + 1;
-    utc.day = days + 1;
+    utc.weekday = calc_weekday(days);
+    days_to_civil(days, &utc);
 
     return utc;
 }
@@ -228,13 +272,143 @@ datetime_t unix_to_localtime(int32_t timestamp, int8_t utc_offset_hours) {
  * Converts Unix time to UTC.
  */ 
 datetime_t unix_to_utc(uint32_t timestamp) {
-    return unix_to_localtime((int32_t)timestamp, 0);
+    return unix_to_localtime(timestamp, 0);
+}
+
+/* DATETIME_CURSOR_RESET
+ * Recompute the broken-down local time of the cursor from scratch.
+ */
+uint8_t datetime_cursor_reset(datetime_cursor_t *cursor, int64_t unix_time, int16_t utc_offset_minutes) {
+    cursor->local = unix_to_localtime(unix_time, utc_offset_minutes);
+    cursor->unix_time = unix_time;
+    cursor->utc_offset_minutes = utc_offset_minutes;
+    cursor->valid = true;
+    return DATETIME_CHANGED_ALL;
+}
+
+/* DATETIME_CURSOR_ADVANCE
+ * Move the cursor forward by propagating carries from seconds to days. Steps bigger than
+ * CURSOR_MAX_ADVANCE_SECONDS fall back to a full computation. An invalid cursor points at no time
+ * to move from, so it is left as it is.
+ */
+uint8_t datetime_cursor_advance(datetime_cursor_t *cursor, uint32_t seconds) {
+    if (!cursor->valid) {
+        LOG_ERR("Datetime cursor is advanced before it is reset.");
+        return 0;
+    }
+    if (seconds > CURSOR_MAX_ADVANCE_SECONDS) {
+        return datetime_cursor_reset(cursor, cursor->unix_time + seconds, cursor->utc_offset_minutes);
+    }
+    if (seconds == 0) return 0;
+
+    datetime_t *local = &cursor->local;
+    uint8_t changed = DATETIME_CHANGED_SECOND;
+    cursor->unix_time += seconds;
+
+    // Carry seconds into minutes.
+    uint32_t carry = local->second + seconds;
+    local->second = carry % 60;
+    carry /= 60;
+    if (!carry) return changed;
+
+    // Carry minutes into hours.
+    changed |= DATETIME_CHANGED_MINUTE;
+    carry += local->minute;
+    local->minute = carry % 60;
+    carry /= 60;
+    if (!carry) return changed;
+
+    // Carry hours into days. The step is less than a day, so there is a single day carry at most.
+    changed |= DATETIME_CHANGED_HOUR;
+    carry += local->hour;
+    local->hour = carry % 24;
+    if (carry < 24) return changed;
+
+    changed |= DATETIME_CHANGED_DAY;
+    advance_one_day(local);
+    return changed;
+}
+
+/* DATETIME_CURSOR_SYNC
+ * Move the cursor to the given UNIX time with the cheapest way possible.
+ */
+uint8_t datetime_cursor_sync(datetime_cursor_t *cursor, int64_t unix_time, int16_t utc_offset_minutes) {
+    // A UTC offset change or a backwards jump requires a full computation.
+    if (!cursor->valid || cursor->utc_offset_minutes != utc_offset_minutes || unix_time < cursor->unix_time
+        || unix_time - cursor->unix_time > CURSOR_MAX_ADVANCE_SECONDS) {
+        return datetime_cursor_reset(cursor, unix_time, utc_offset_minutes);
+    }
+    return datetime_cursor_advance(cursor, (uint32_t)(unix_time - cursor->unix_time));
 }
 
 /** **************** **/
 /** STATIC FUNCTIONS **/
 /** **************** **/
 
+/* FLOOR_DIV
+ * Integer division that rounds towards negative infinity. Internal purposes.
+ */
+static int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return quotient - ((value % divisor) < 0);
+}
+
+/* CALC_WEEKDAY
+ * Calculate the day of the given days after epoch.
+ */
+static uint8_t calc_weekday(int64_t days_since_epoch) {
+    // 1970-01-01 = Thursday
+    return (uint8_t)(days_since_epoch + 4 - floor_div(days_since_epoch + 4, 7) * 7);
+}
+
+/* DAYS_TO_CIVIL
+ * Convert days since 1970-01-01 to year, month and day in O(1). The calendar is split into 400-year
+ * eras of 146097 days, which repeat exactly. Inside an era, the year is computed directly from the
+ * day count by correcting for the 4/100/400 leap year rules, and the month is found in a year that
+ * starts at March 1st (see days_before_shifted_month).
+ */
+static void days_to_civil(int64_t days_since_epoch, datetime_t *datetime) {
+    // Shift the epoch to 0000-03-01.
+    int64_t shifted_days = days_since_epoch + 719468;
+    int64_t era = floor_div(shifted_days, 146097);
+    uint32_t day_of_era = (uint32_t)(shifted_days - era * 146097);                      // [0, 146096]
+    uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524
+                            - day_of_era / 146096) / 365;                               // [0, 399]
+    uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4
+                                         - year_of_era / 100);                          // [0, 365]
+    uint32_t shifted_month = (5 * day_of_year + 2) / 153;                               // [0, 11]
+
+    datetime->day = day_of_year - days_before_shifted_month[shifted_month] + 1;
+    datetime->month = shifted_month_to_civil[shifted_month];
+    // January and February belong to the next civil year.
+    datetime->year = (uint16_t)(era * 400 + year_of_era + (shifted_month >= 10));
+}
+
+/* UPDATE_TIME_BASE
+ * Move the time base snapshot to the current counter value, and return the current time in
+ * microseconds. The elapsed ticks are computed modulo the counter's top value to handle wraparound.
+ */
+static int64_t update_time_base() {
+    int64_t now_us;
+
+    K_SPINLOCK(&time_base_lock) {
+        if (time_base_running) {
+            uint32_t counter_value;
+            counter_get_value(real_time_counter, &counter_value);
+
+            // Compute the elapsed ticks with wraparound.
+            uint64_t period = (uint64_t)counter_get_top_value(real_time_counter) + 1;
+            uint64_t elapsed = ((uint64_t)counter_value + period - counter_snapshot) % period;
+
+            counter_snapshot = counter_value;
+            base_time_us += drift_compensated_us(counter_get_frequency(real_time_counter), elapsed);
+        }
+        now_us = base_time_us;
+    }
+
+    return now_us;
+}
+
 /* IS_LEAP_YEAR
  * Check if the year is a leap year. Internal purposes.
  */
@@ -242,9 +416,27 @@ static bool is_leap_year(uint16_t year) {
     return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
 }
 
-/* CALC_WEEKDAY
- * Calculate the day of the given days after epoch.
+/* CALC_DAYS_IN_MONTH
+ * Return the number of days in the given month (1-12) of the year.
  */
-static uint8_t calc_weekday(uint32_t days_since_epoch) {
-    return (days_since_epoch + 4) % 7; // 1970-01-01 = Thursday
+static uint8_t calc_days_in_month(uint16_t year, uint8_t month) {
+    return days_in_month[month - 1] + (month == 2 && is_leap_year(year));
+}
+
+/* ADVANCE_ONE_DAY
+ * Move the date part of the datetime to the next day with month and year carries.
+ */
+static void advance_one_day(datetime_t *datetime) {
+    datetime->weekday = (datetime->weekday + 1) % 7;
+    if (datetime->day < calc_days_in_month(datetime->year, datetime->month)) {
+        datetime->day++;
+        return;
+    }
+    datetime->day = 1;
+    if (datetime->month < 12) {
+        datetime->month++;
+        return;
+    }
+    datetime->month = 1;
+    datetime->year++;
 }
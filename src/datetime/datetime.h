@@ -9,6 +9,7 @@
 #define _DATETIME_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,29 +24,76 @@ typedef struct {
     uint8_t  minute; // 0–59
     uint8_t  second; // 0–59
     uint8_t  weekday; // 0 = Sunday, ..., 6 = Saturday
+    uint16_t millisecond; // 0–999
 } datetime_t;
 
+/* Flags to report which fields of a datetime cursor are changed after an update. */
+#define DATETIME_CHANGED_SECOND (1 << 0)
+#define DATETIME_CHANGED_MINUTE (1 << 1)
+#define DATETIME_CHANGED_HOUR   (1 << 2)
+#define DATETIME_CHANGED_DAY    (1 << 3) // Day, month, year and weekday.
+#define DATETIME_CHANGED_ALL    (DATETIME_CHANGED_SECOND | DATETIME_CHANGED_MINUTE | \
+                                 DATETIME_CHANGED_HOUR | DATETIME_CHANGED_DAY)
+
+/* A cursor that keeps the broken-down local time of a UNIX time. It is moved forward with carries
+ * only, instead of converting the UNIX time from scratch on every update.
+ */
+typedef struct {
+    datetime_t local;         // Broken-down local time of unix_time.
+    int64_t unix_time;        // UNIX time the cursor is pointing at.
+    int16_t utc_offset_minutes; // UTC offset the local time is computed for.
+    bool valid;               // False until the first full computation.
+} datetime_cursor_t;
+
 /* Enables the subsystem to track the real time. */
 int enable_datetime_subsystem();
 
 /* Disables the subsystem. */
 int disable_datetime_subsystem();
 
-/* Get the current time in UNIX epochs. */
+/* Get the current time in UNIX epochs. It is derived from the millisecond time. */
 uint32_t get_current_unix_time();
 
 /* Set the current time in UNIX epochs. */
 int set_current_unix_time(uint32_t new_time);
 
-/* Get the current time in datetime_t struct in local time zone. */
-datetime_t get_current_local_time(int8_t utc_offset_hours);
+/* Get the current time in milliseconds since UNIX epoch. */
+int64_t get_current_unix_time_ms();
+
+/* Set the current time in milliseconds since UNIX epoch. */
+int set_current_unix_time_ms(int64_t new_time_ms);
+
+/* Get the current time in milliseconds since UNIX epoch with the counter value it is measured at. */
+void get_time_base_snapshot(int64_t *unix_time_ms, uint32_t *counter_value);
+
+/* Restore the time from a snapshot taken before a reset, adding the counter ticks elapsed since. */
+int restore_time_base_snapshot(int64_t unix_time_ms, uint32_t counter_value);
 
-/* Converts Unix time to local time using datetime_t. */
-datetime_t unix_to_localtime(int32_t timestamp, int8_t utc_offset_hours);
+/* Get the current time in datetime_t struct in the given time zone, including milliseconds. */
+datetime_t get_current_local_time(uint8_t timezone_id);
+
+/* Converts Unix time to local time with the UTC offset in minutes using datetime_t. */
+datetime_t unix_to_localtime(int64_t timestamp, int16_t utc_offset_minutes);
+
+/* Converts Unix time in milliseconds to local time using datetime_t, including milliseconds. */
+datetime_t unix_ms_to_localtime(int64_t timestamp_ms, int16_t utc_offset_minutes);
 
 /* Converts Unix time to UTC using datetime_t. */
 datetime_t unix_to_utc(uint32_t timestamp);
 
+/* Point the cursor to the given UNIX time with a full computation. Returns DATETIME_CHANGED_ALL. */
+uint8_t datetime_cursor_reset(datetime_cursor_t *cursor, int64_t unix_time, int16_t utc_offset_minutes);
+
+/* Move the cursor forward by the given seconds. Returns DATETIME_CHANGED_* flags. The cursor must be
+ * reset first; an invalid cursor is not moved, and no flag is returned.
+ */
+uint8_t datetime_cursor_advance(datetime_cursor_t *cursor, uint32_t seconds);
+
+/* Move the cursor to the given UNIX time. It advances the cursor if the time moved forward a bit,
+ * and resets it on a time jump or a UTC offset change. Returns DATETIME_CHANGED_* flags.
+ */
+uint8_t datetime_cursor_sync(datetime_cursor_t *cursor, int64_t unix_time, int16_t utc_offset_minutes);
+
 #ifdef __cplusplus
 }
 #endif
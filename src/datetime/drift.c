@@ -0,0 +1,162 @@
+/** Drift Compensation for ZephyrWatch Datetime Subsystem
+ * It learns the frequency error of the real-time counter from successive time synchronizations,
+ * and keeps the estimate in the settings storage to survive reboots.
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+*/
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "datetime/drift.h"
+
+/* Register a logger for this library. */
+LOG_MODULE_REGISTER(ZephyrWatch_Drift, LOG_LEVEL_INF);
+
+/* Our board's RTC is a real-time counter running from an inaccurate clock source. Without any
+ * synchronization, it is measured to be 4 minutes per hour slow on the reference board. That is
+ * one second per 15 seconds, which is 66667 ppm. It is used until a better estimate is learned.
+ */
+#define DRIFT_DEFAULT_PPM 66667
+
+/* Estimates beyond this limit are treated as invalid measurements, e.g. a manual time change. */
+#define DRIFT_MAX_PPM 200000
+
+/* Minimum time between two synchronizations to measure the drift. Since the received time has one
+ * second resolution, shorter intervals give too much quantization error (1666 ppm for 10 minutes).
+ */
+#define DRIFT_MIN_INTERVAL_MS (600 * MSEC_PER_SEC)
+
+/* Each measurement moves the estimate by 1/2^DRIFT_FILTER_SHIFT of its error. */
+#define DRIFT_FILTER_SHIFT 1
+
+/* Settings key of the stored estimate. */
+#define DRIFT_SETTINGS_ROOT "drift"
+#define DRIFT_SETTINGS_PPM_KEY "ppm"
+
+static int32_t drift_ppm = DRIFT_DEFAULT_PPM;
+static int64_t last_sync_time_ms = 0;
+static bool has_last_sync = false;
+static int64_t skipped_error_ms = 0;
+static uint64_t us_remainder = 0;
+
+/* Prototype definition of internal static functions. */
+static int drift_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg);
+static void save_drift_ppm();
+
+SETTINGS_STATIC_HANDLER_DEFINE(drift, DRIFT_SETTINGS_ROOT, NULL, drift_settings_set, NULL, NULL);
+
+/* DRIFT_GET_PPM
+ * Return the current drift estimate.
+ */
+int32_t drift_get_ppm() {
+    return drift_ppm;
+}
+
+/* DRIFT_SET_PPM
+ * Override the current drift estimate.
+ */
+void drift_set_ppm(int32_t ppm) {
+    drift_ppm = ppm;
+}
+
+/* DRIFT_PROCESS_SYNC
+ * Measure the error of the device time since the previous synchronization. Since the device time
+ * is already compensated with the current estimate, the measured error is the residual of the
+ * estimate, and the estimate is corrected by a fraction of it. The caller corrects the device time
+ * after each synchronization, so the corrections of the synchronizations too close to the reference
+ * point are added up and counted in the next measurement.
+ */
+int32_t drift_process_sync(int64_t device_time_ms, int64_t reference_time_ms) {
+    // The first synchronization only sets the reference point.
+    if (!has_last_sync || reference_time_ms <= last_sync_time_ms) {
+        last_sync_time_ms = reference_time_ms;
+        has_last_sync = true;
+        skipped_error_ms = 0;
+        return drift_ppm;
+    }
+
+    // Wait for a longer interval to keep the previous reference point, and keep its correction.
+    int64_t interval = reference_time_ms - last_sync_time_ms;
+    if (interval < DRIFT_MIN_INTERVAL_MS) {
+        skipped_error_ms += reference_time_ms - device_time_ms;
+        LOG_DBG("Synchronization interval is too short to measure drift (%lld ms).", interval);
+        return drift_ppm;
+    }
+    last_sync_time_ms = reference_time_ms;
+
+    // Compute the residual of the current estimate in ppm, over all the corrections since the
+    // reference point.
+    int64_t error = reference_time_ms - device_time_ms + skipped_error_ms;
+    skipped_error_ms = 0;
+    int64_t residual_ppm = error * 1000000 / interval;
+    int64_t new_ppm = drift_ppm + (residual_ppm / (1 << DRIFT_FILTER_SHIFT));
+    if (llabs(new_ppm) > DRIFT_MAX_PPM) {
+        LOG_WRN("Drift measurement is ignored (error %lld ms in %lld ms).", error, interval);
+        return drift_ppm;
+    }
+
+    LOG_INF("Drift estimate is updated from %d ppm to %d ppm (error %lld ms in %lld ms).",
+            drift_ppm, (int32_t)new_ppm, error, interval);
+    if (new_ppm != drift_ppm) {
+        drift_ppm = (int32_t)new_ppm;
+        save_drift_ppm();
+    }
+    return drift_ppm;
+}
+
+/* DRIFT_COMPENSATED_US
+ * If the counter is slow by drift_ppm, the ticks elapsed in a real second is
+ * frequency * 1e6 / (1e6 + drift_ppm). Thus, the real time of the ticks is
+ * ticks * (1e6 + drift_ppm) / frequency microseconds. The division is carried out in integers,
+ * and its remainder is accumulated to the next call.
+ */
+uint64_t drift_compensated_us(uint32_t frequency_hz, uint64_t ticks) {
+    uint64_t numerator = ticks * (uint64_t)(1000000 + drift_ppm) + us_remainder;
+    us_remainder = numerator % frequency_hz;
+    return numerator / frequency_hz;
+}
+
+/* DRIFT_COMPENSATED_TICKS
+ * The inverse of drift_compensated_us(), without carrying the remainder. It is used to program
+ * the counter alarms for a real duration.
+ */
+uint64_t drift_compensated_ticks(uint32_t frequency_hz, uint64_t duration_us) {
+    return duration_us * frequency_hz / (uint64_t)(1000000 + drift_ppm);
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* DRIFT_SETTINGS_SET
+ * Settings handler to load the stored drift estimate.
+ */
+static int drift_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+    const char *next;
+    if (settings_name_steq(name, DRIFT_SETTINGS_PPM_KEY, &next) && !next) {
+        if (len != sizeof(drift_ppm)) return -EINVAL;
+
+        int32_t stored_ppm;
+        int ret = read_cb(cb_arg, &stored_ppm, sizeof(stored_ppm));
+        if (ret < 0) return ret;
+
+        drift_ppm = stored_ppm;
+        LOG_INF("Drift estimate is loaded: %d ppm.", drift_ppm);
+        return 0;
+    }
+    return -ENOENT;
+}
+
+/* SAVE_DRIFT_PPM
+ * Store the drift estimate to the settings storage.
+ */
+static void save_drift_ppm() {
+    int ret = settings_save_one(DRIFT_SETTINGS_ROOT "/" DRIFT_SETTINGS_PPM_KEY, &drift_ppm, sizeof(drift_ppm));
+    if (ret) {
+        LOG_ERR("Failed to save drift estimate (ret %d).", ret);
+    }
+}
@@ -0,0 +1,41 @@
+/** Drift Compensation for ZephyrWatch Datetime Subsystem
+ * It learns the frequency error of the real-time counter from successive time synchronizations,
+ * and keeps the estimate in the settings storage to survive reboots.
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+*/
+
+#ifndef _DATETIME_DRIFT_H
+#define _DATETIME_DRIFT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Get the estimated drift in parts per million. Positive values mean the counter is slow. */
+int32_t drift_get_ppm();
+
+/* Override the estimated drift in parts per million. */
+void drift_set_ppm(int32_t ppm);
+
+/* Feed a time synchronization to the estimator. The device_time_ms is the time of the device just
+ * before the synchronization, and reference_time_ms is the received time. Returns the new estimate.
+ */
+int32_t drift_process_sync(int64_t device_time_ms, int64_t reference_time_ms);
+
+/* Convert the elapsed counter ticks to real microseconds, compensating the drift. The sub-microsecond
+ * remainder is carried to the next call, so no fraction is lost between the conversions.
+ */
+uint64_t drift_compensated_us(uint32_t frequency_hz, uint64_t ticks);
+
+/* Convert a real duration in microseconds to counter ticks, compensating the drift. */
+uint64_t drift_compensated_ticks(uint32_t frequency_hz, uint64_t duration_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
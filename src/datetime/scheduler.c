@@ -0,0 +1,252 @@
+/** Wall-Clock Scheduler for ZephyrWatch Datetime Subsystem
+ * It runs callbacks at given UNIX times. The events are kept in a min-heap ordered by their
+ * deadlines, and a single real-time counter alarm is programmed for the earliest one.
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+*/
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/counter.h>
+
+#include "datetime/datetime.h"
+#include "datetime/drift.h"
+#include "datetime/scheduler.h"
+
+// Get devices from the device tree.
+#define RTC_COUNTER_DEVICE DT_ALIAS(rtccounterdevice)
+
+// Configuration for counter alarm.
+#define ALARM_CHANNEL_ID 0
+
+/* Register a logger for this library. */
+LOG_MODULE_REGISTER(ZephyrWatch_Scheduler, LOG_LEVEL_INF);
+
+/* The alarm is never programmed further than half of the counter's wrap period. If there is no
+ * event, or the earliest one is far away, the alarm wakes the scheduler up only to re-evaluate.
+ * It also keeps the datetime time base reading the counter at least once per wrap period.
+ */
+static const struct device *real_time_counter = DEVICE_DT_GET(RTC_COUNTER_DEVICE);
+static struct counter_alarm_cfg alarm_cfg;
+
+/* The min-heap of scheduled events. The earliest deadline is at the top (index 0). */
+static struct k_spinlock heap_lock;
+static wallclock_event_t *heap[WALLCLOCK_MAX_EVENTS];
+static uint16_t heap_size = 0;
+
+/* The scheduled events are dispatched in the system work queue, not in the alarm ISR. */
+static struct k_work dispatch_work;
+static bool scheduler_enabled = false;
+
+/* Prototype definition of internal static functions. */
+static void alarm_isr(const struct device *dev, uint8_t channel_id, uint32_t ticks, void *user_data);
+static void dispatch_worker(struct k_work *work);
+static void program_alarm(int64_t now_ms);
+static void heap_swap(uint16_t a, uint16_t b);
+static void heap_sift_up(uint16_t index);
+static void heap_sift_down(uint16_t index);
+static void heap_remove(uint16_t index);
+
+/* ENABLE_WALLCLOCK_SCHEDULER
+ * Prepare the counter alarm and start evaluating the schedule.
+ */
+int enable_wallclock_scheduler() {
+    if (!device_is_ready(real_time_counter)) {
+        LOG_ERR("Real time counter device is not ready.");
+        return -ENODEV;
+    }
+    LOG_DBG("Real time counter device is ready.");
+
+    // Configure the alarm structure. The ticks are set when it is programmed.
+    alarm_cfg.flags = 0;
+    alarm_cfg.callback = alarm_isr;
+    alarm_cfg.user_data = NULL;
+
+    k_work_init(&dispatch_work, dispatch_worker);
+    scheduler_enabled = true;
+    k_work_submit(&dispatch_work);
+    LOG_DBG("Wall-clock scheduler is enabled.");
+
+    return 0;
+}
+
+/* WALLCLOCK_EVENT_INIT
+ * Initialize the event as not scheduled.
+ */
+void wallclock_event_init(wallclock_event_t *event, wallclock_callback_t callback, void *user_data) {
+    event->deadline_ms = 0;
+    event->callback = callback;
+    event->user_data = user_data;
+    event->heap_index = -1;
+}
+
+/* WALLCLOCK_SCHEDULE
+ * Insert the event to the heap, or move it if it is already scheduled. If the earliest deadline
+ * changes, the alarm is re-programmed from the work queue.
+ */
+int wallclock_schedule(wallclock_event_t *event, int64_t deadline_ms) {
+    int ret = 0;
+    bool is_earliest = false;
+
+    K_SPINLOCK(&heap_lock) {
+        if (event->heap_index < 0) {
+            if (heap_size >= WALLCLOCK_MAX_EVENTS) {
+                ret = -ENOMEM;
+                K_SPINLOCK_BREAK;
+            }
+            event->heap_index = heap_size;
+            heap[heap_size++] = event;
+        }
+        event->deadline_ms = deadline_ms;
+        heap_sift_up(event->heap_index);
+        heap_sift_down(event->heap_index);
+        is_earliest = (event->heap_index == 0);
+    }
+
+    if (ret) {
+        LOG_ERR("Too many wall-clock events are scheduled.");
+        return ret;
+    }
+    if (is_earliest) {
+        wallclock_reschedule();
+    }
+    return 0;
+}
+
+/* WALLCLOCK_CANCEL
+ * Remove the event from the heap. The alarm is left as is, an early wake-up is harmless.
+ */
+void wallclock_cancel(wallclock_event_t *event) {
+    K_SPINLOCK(&heap_lock) {
+        if (event->heap_index >= 0) {
+            heap_remove(event->heap_index);
+        }
+    }
+}
+
+/* WALLCLOCK_RESCHEDULE
+ * Dispatch the due events and re-program the alarm from the work queue.
+ */
+void wallclock_reschedule() {
+    if (scheduler_enabled) {
+        k_work_submit(&dispatch_work);
+    }
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* ALARM_ISR
+ * Interrupt service routine for the counter alarm. It defers the dispatching to the work queue.
+ */
+static void alarm_isr(const struct device *dev, uint8_t channel_id, uint32_t ticks, void *user_data) {
+    k_work_submit(&dispatch_work);
+}
+
+/* DISPATCH_WORKER
+ * Run the callbacks of all the due events, and program the alarm for the earliest remaining one.
+ * The callbacks are called without the lock, so they can schedule events again.
+ */
+static void dispatch_worker(struct k_work *work) {
+    int64_t now_ms = get_current_unix_time_ms();
+
+    while (true) {
+        wallclock_event_t *due_event = NULL;
+        K_SPINLOCK(&heap_lock) {
+            if (heap_size > 0 && heap[0]->deadline_ms <= now_ms) {
+                due_event = heap[0];
+                heap_remove(0);
+            }
+        }
+        if (due_event == NULL) break;
+
+        LOG_DBG("Dispatching wall-clock event at %lld ms.", due_event->deadline_ms);
+        due_event->callback(due_event);
+    }
+
+    program_alarm(now_ms);
+}
+
+/* PROGRAM_ALARM
+ * Set the counter alarm for the earliest deadline, limited to half of the wrap period.
+ */
+static void program_alarm(int64_t now_ms) {
+    uint32_t frequency_hz = counter_get_frequency(real_time_counter);
+    uint64_t max_ticks = counter_get_top_value(real_time_counter) / 2;
+    uint64_t ticks = max_ticks;
+
+    // The delay is limited to half of the wrap period before the conversion, so the microseconds
+    // times the frequency stay below 2^31 * 10^6 and do not overflow.
+    int64_t max_delay_ms = MAX((int64_t)(max_ticks * MSEC_PER_SEC / frequency_hz), 1);
+
+    K_SPINLOCK(&heap_lock) {
+        if (heap_size > 0) {
+            int64_t delay_ms = CLAMP(heap[0]->deadline_ms - now_ms, 1, max_delay_ms);
+            ticks = drift_compensated_ticks(frequency_hz, (uint64_t)delay_ms * USEC_PER_MSEC);
+        }
+    }
+
+    alarm_cfg.ticks = (uint32_t)CLAMP(ticks, 1, max_ticks);
+    counter_cancel_channel_alarm(real_time_counter, ALARM_CHANNEL_ID);
+    int ret = counter_set_channel_alarm(real_time_counter, ALARM_CHANNEL_ID, &alarm_cfg);
+    if (ret) {
+        LOG_ERR("Failed to set channel alarm (ret %d).", ret);
+    }
+}
+
+/* HEAP_SWAP
+ * Swap two heap entries and update their indices.
+ */
+static void heap_swap(uint16_t a, uint16_t b) {
+    wallclock_event_t *temp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = temp;
+    heap[a]->heap_index = a;
+    heap[b]->heap_index = b;
+}
+
+/* HEAP_SIFT_UP
+ * Move the entry towards the top while it is earlier than its parent.
+ */
+static void heap_sift_up(uint16_t index) {
+    while (index > 0) {
+        uint16_t parent = (index - 1) / 2;
+        if (heap[parent]->deadline_ms <= heap[index]->deadline_ms) break;
+        heap_swap(parent, index);
+        index = parent;
+    }
+}
+
+/* HEAP_SIFT_DOWN
+ * Move the entry towards the bottom while it is later than one of its children.
+ */
+static void heap_sift_down(uint16_t index) {
+    while (true) {
+        uint16_t earliest = index;
+        uint16_t left = 2 * index + 1;
+        uint16_t right = left + 1;
+        if (left < heap_size && heap[left]->deadline_ms < heap[earliest]->deadline_ms) earliest = left;
+        if (right < heap_size && heap[right]->deadline_ms < heap[earliest]->deadline_ms) earliest = right;
+        if (earliest == index) break;
+        heap_swap(index, earliest);
+        index = earliest;
+    }
+}
+
+/* HEAP_REMOVE
+ * Remove the entry at the index by replacing it with the last entry.
+ */
+static void heap_remove(uint16_t index) {
+    heap[index]->heap_index = -1;
+    heap_size--;
+    if (index == heap_size) return;
+
+    wallclock_event_t *moved = heap[heap_size];
+    heap[index] = moved;
+    moved->heap_index = index;
+    heap_sift_up(index);
+    heap_sift_down(moved->heap_index);
+}
@@ -0,0 +1,55 @@
+/** Wall-Clock Scheduler for ZephyrWatch Datetime Subsystem
+ * It runs callbacks at given UNIX times. The events are kept in a min-heap ordered by their
+ * deadlines, and a single real-time counter alarm is programmed for the earliest one.
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+*/
+
+#ifndef _DATETIME_SCHEDULER_H
+#define _DATETIME_SCHEDULER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of events that can be scheduled at the same time. */
+#define WALLCLOCK_MAX_EVENTS 16
+
+typedef struct wallclock_event wallclock_event_t;
+
+/* The callback of an event. It runs in the system work queue. */
+typedef void (*wallclock_callback_t)(wallclock_event_t *event);
+
+/* An event to be scheduled. It is owned by the caller, and must stay valid while scheduled. */
+struct wallclock_event {
+    int64_t deadline_ms;            // UNIX time in milliseconds to run the callback.
+    wallclock_callback_t callback;
+    void *user_data;
+    int16_t heap_index;             // Position in the heap, -1 if not scheduled.
+};
+
+/* Enables the scheduler. The datetime subsystem must be enabled beforehand. */
+int enable_wallclock_scheduler();
+
+/* Initialize an event with its callback and user data. */
+void wallclock_event_init(wallclock_event_t *event, wallclock_callback_t callback, void *user_data);
+
+/* Schedule the event at the given UNIX time in milliseconds. A scheduled event is moved to the new
+ * deadline. Returns 0 on success, -ENOMEM if there are too many events.
+ */
+int wallclock_schedule(wallclock_event_t *event, int64_t deadline_ms);
+
+/* Remove the event from the schedule if it is scheduled. */
+void wallclock_cancel(wallclock_event_t *event);
+
+/* Re-evaluate the schedule. It must be called when the current time jumps. */
+void wallclock_reschedule();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
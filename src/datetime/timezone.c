@@ -0,0 +1,125 @@
+/** Time Zone Rules for ZephyrWatch Datetime Subsystem
+ * It provides UTC offsets with daylight saving time and sub-hour offsets, using a transition table
+ * generated from the tz database at build time (scripts/generate_timezones.py).
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+*/
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "datetime/timezone.h"
+
+/* Register a logger for this library. */
+LOG_MODULE_REGISTER(ZephyrWatch_Timezone, LOG_LEVEL_INF);
+
+/* The offset is asked for the same zone and nearly the same time over and over. Thus, the last
+ * lookup is cached with the interval its offset is valid in, and a lookup inside the interval
+ * costs a single comparison. The interval ends at the next transition.
+ */
+typedef struct {
+    bool valid;
+    uint8_t timezone_id;
+    int64_t valid_from;
+    int64_t valid_until;
+    int16_t offset_minutes;
+} timezone_cache_t;
+
+static struct k_spinlock cache_lock;
+static timezone_cache_t cache = { .valid = false };
+
+/* Prototype definition of internal static functions. */
+static int32_t find_transition_index(const timezone_rule_t *rule, int64_t unix_time);
+
+/* TIMEZONE_FIND
+ * Search the time zone table for the given name.
+ */
+int timezone_find(const char *name) {
+    for (uint8_t id = 0; id < timezone_rule_count; id++) {
+        if (strcmp(timezone_rules[id].name, name) == 0) {
+            return id;
+        }
+    }
+    return -ENOENT;
+}
+
+/* TIMEZONE_GET_NAME
+ * Return the name of the time zone. An invalid time zone is named UTC, since its offset is zero.
+ */
+const char *timezone_get_name(uint8_t timezone_id) {
+    if (timezone_id >= timezone_rule_count) return "UTC";
+    return timezone_rules[timezone_id].name;
+}
+
+/* TIMEZONE_GET_OFFSET_MINUTES
+ * Return the UTC offset of the time zone. It answers from the cache if the time is in the cached
+ * interval, otherwise it searches the transitions and refills the cache.
+ */
+int16_t timezone_get_offset_minutes(uint8_t timezone_id, int64_t unix_time) {
+    if (timezone_id >= timezone_rule_count) {
+        LOG_ERR("Invalid time zone id: %u", timezone_id);
+        return 0;
+    }
+
+    int16_t offset_minutes;
+    K_SPINLOCK(&cache_lock) {
+        // Hot path: the cached offset is still valid.
+        if (cache.valid && cache.timezone_id == timezone_id
+            && unix_time >= cache.valid_from && unix_time < cache.valid_until) {
+            offset_minutes = cache.offset_minutes;
+            K_SPINLOCK_BREAK;
+        }
+
+        // Find the last transition before the time, and cache the interval until the next one.
+        const timezone_rule_t *rule = &timezone_rules[timezone_id];
+        int32_t index = find_transition_index(rule, unix_time);
+        cache.timezone_id = timezone_id;
+        cache.valid_from = (index < 0) ? INT64_MIN : rule->transitions[index].start;
+        cache.valid_until = (index + 1 < rule->transition_count)
+            ? rule->transitions[index + 1].start : INT64_MAX;
+        cache.offset_minutes = (index < 0)
+            ? rule->initial_offset_minutes : rule->transitions[index].offset_minutes;
+        cache.valid = true;
+        offset_minutes = cache.offset_minutes;
+    }
+
+    return offset_minutes;
+}
+
+/* TIMEZONE_GET_NEXT_TRANSITION
+ * Return the time of the next offset change of the time zone.
+ */
+int64_t timezone_get_next_transition(uint8_t timezone_id, int64_t unix_time) {
+    if (timezone_id >= timezone_rule_count) return INT64_MAX;
+
+    const timezone_rule_t *rule = &timezone_rules[timezone_id];
+    int32_t index = find_transition_index(rule, unix_time);
+    if (index + 1 >= rule->transition_count) return INT64_MAX;
+    return rule->transitions[index + 1].start;
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* FIND_TRANSITION_INDEX
+ * Binary search for the last transition that starts at or before the given time. Returns -1 if
+ * the time is before the first transition.
+ */
+static int32_t find_transition_index(const timezone_rule_t *rule, int64_t unix_time) {
+    int32_t low = 0;
+    int32_t high = rule->transition_count;
+
+    // Find the first transition starting after the time.
+    while (low < high) {
+        int32_t middle = low + (high - low) / 2;
+        if (rule->transitions[middle].start <= unix_time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low - 1;
+}
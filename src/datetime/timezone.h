@@ -0,0 +1,54 @@
+/** Time Zone Rules for ZephyrWatch Datetime Subsystem
+ * It provides UTC offsets with daylight saving time and sub-hour offsets, using a transition table
+ * generated from the tz database at build time (scripts/generate_timezones.py).
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+*/
+
+#ifndef _DATETIME_TIMEZONE_H
+#define _DATETIME_TIMEZONE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A change of the UTC offset, effective from the given UNIX time. */
+typedef struct {
+    uint32_t start;          // UNIX time the offset starts.
+    int16_t offset_minutes;  // UTC offset in minutes, e.g. +330 for UTC+5:30.
+} timezone_transition_t;
+
+/* The rules of a time zone as its transitions sorted by time. */
+typedef struct {
+    const char *name;                            // tz database name, e.g. "Europe/Berlin".
+    int16_t initial_offset_minutes;              // UTC offset before the first transition.
+    const timezone_transition_t *transitions;
+    uint16_t transition_count;
+} timezone_rule_t;
+
+/* The generated time zone table. */
+extern const timezone_rule_t timezone_rules[];
+extern const uint8_t timezone_rule_count;
+
+/* Find the id of the time zone by its tz database name. Returns the id, or -ENOENT. */
+int timezone_find(const char *name);
+
+/* Get the tz database name of the time zone. Returns "UTC" if the id is invalid, matching its offset. */
+const char *timezone_get_name(uint8_t timezone_id);
+
+/* Get the UTC offset of the time zone in minutes at the given UNIX time. */
+int16_t timezone_get_offset_minutes(uint8_t timezone_id, int64_t unix_time);
+
+/* Get the UNIX time of the first offset change after the given UNIX time, or INT64_MAX if none. */
+int64_t timezone_get_next_transition(uint8_t timezone_id, int64_t unix_time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,20 +5,115 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/zbus/zbus.h>
 #include "devicetwin/devicetwin.h"
 
+// The window to coalesce the changes into a single notification.
+#define CHANGE_COALESCE_MS 50
+
 // Function to construct a single device twin instance. This is a singleton.
 static device_twin_t* s_device_twin_instance = NULL;
 
+/* The twin is written from ISRs and threads, and read from everywhere. It is protected with a
+ * sequence lock: the writers are serialized with a spinlock and keep the sequence odd while
+ * writing, the readers never block and retry their copy if the sequence changed in between.
+ * Since the spinlock masks the interrupts, an ISR never preempts a writer on the same CPU.
+ */
+static struct k_spinlock s_write_lock;
+static atomic_t s_sequence = ATOMIC_INIT(0);
+
+/* The changed fields are accumulated in a dirty mask, and published from the system work queue
+ * after the coalescing window. The first change in the window schedules the publication.
+ */
+static atomic_t s_dirty_fields = ATOMIC_INIT(0);
+static void publish_changes_worker(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(s_publish_work, publish_changes_worker);
+
+ZBUS_CHAN_DEFINE(device_twin_chan,
+                 device_twin_event_t,
+                 NULL,
+                 NULL,
+                 ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(.changed_fields = 0));
+
 device_twin_t* get_device_twin_instance(void) {
     return s_device_twin_instance;
 }
 
-device_twin_t* create_device_twin_instance(uint32_t unix_time, int8_t utc_zone) {
+device_twin_t* create_device_twin_instance(int64_t unix_time_ms, uint8_t timezone_id) {
     device_twin_t* instance = malloc(sizeof(device_twin_t));
-    instance->unix_time = unix_time;
-    instance->utc_zone = utc_zone;
+    instance->unix_time_ms = unix_time_ms;
+    instance->timezone_id = timezone_id;
     // For now, we'll assume the singleton instance is always created.
     s_device_twin_instance = instance;
     return instance;
 }
+
+int device_twin_snapshot(device_twin_t* snapshot) {
+    if (s_device_twin_instance == NULL) return -ENODEV;
+
+    atomic_val_t sequence;
+    do {
+        // Wait for the ongoing write to finish.
+        sequence = atomic_get(&s_sequence);
+        if (sequence & 1) continue;
+
+        barrier_dmem_fence_full();
+        memcpy(snapshot, s_device_twin_instance, sizeof(device_twin_t));
+        barrier_dmem_fence_full();
+    } while ((sequence & 1) || atomic_get(&s_sequence) != sequence);
+
+    return 0;
+}
+
+device_twin_t* device_twin_write_begin(k_spinlock_key_t* key) {
+    *key = k_spin_lock(&s_write_lock);
+    atomic_inc(&s_sequence);
+    barrier_dmem_fence_full();
+    return s_device_twin_instance;
+}
+
+void device_twin_write_commit(k_spinlock_key_t key, uint32_t changed_fields) {
+    barrier_dmem_fence_full();
+    atomic_inc(&s_sequence);
+    k_spin_unlock(&s_write_lock, key);
+
+    if (changed_fields) {
+        atomic_or(&s_dirty_fields, changed_fields);
+        k_work_schedule(&s_publish_work, K_MSEC(CHANGE_COALESCE_MS));
+    }
+}
+
+int device_twin_set_unix_time_ms(int64_t unix_time_ms) {
+    if (s_device_twin_instance == NULL) return -ENODEV;
+
+    k_spinlock_key_t key;
+    device_twin_t* device_twin = device_twin_write_begin(&key);
+    device_twin->unix_time_ms = unix_time_ms;
+    device_twin_write_commit(key, DEVICE_TWIN_FIELD_UNIX_TIME);
+    return 0;
+}
+
+int device_twin_set_timezone_id(uint8_t timezone_id) {
+    if (s_device_twin_instance == NULL) return -ENODEV;
+
+    k_spinlock_key_t key;
+    device_twin_t* device_twin = device_twin_write_begin(&key);
+    uint32_t changed_fields = (device_twin->timezone_id != timezone_id) ? DEVICE_TWIN_FIELD_TIMEZONE : 0;
+    device_twin->timezone_id = timezone_id;
+    device_twin_write_commit(key, changed_fields);
+    return 0;
+}
+
+static void publish_changes_worker(struct k_work *work) {
+    device_twin_event_t event = {
+        .changed_fields = (uint32_t)atomic_clear(&s_dirty_fields),
+    };
+    if (event.changed_fields) {
+        zbus_chan_pub(&device_twin_chan, &event, K_NO_WAIT);
+    }
+}
@@ -8,6 +8,8 @@
 #ifndef _DEVICE_TWIN_H
 #define _DEVICE_TWIN_H
 
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
 #include "datetime/datetime.h"
 
 #ifdef __cplusplus
@@ -20,20 +22,59 @@ extern "C" {
  * health monitoring, time, user settings, etc.
  */
 typedef struct {
-    uint32_t unix_time;
-    int8_t utc_zone;
+    int64_t unix_time_ms;  // The last set, saved or frozen time. Read the clock for the current time.
+    uint8_t timezone_id;
 } device_twin_t;
 
+/* Bits of the device twin fields, used to report which fields are changed. */
+#define DEVICE_TWIN_FIELD_UNIX_TIME BIT(0)  // The time is set, e.g. synchronized. Not its ticking.
+#define DEVICE_TWIN_FIELD_TIMEZONE  BIT(1)
+
+/* The message published on device_twin_chan. Changes committed within a short window are
+ * coalesced into a single message.
+ */
+typedef struct {
+    uint32_t changed_fields;  // DEVICE_TWIN_FIELD_* bits.
+} device_twin_event_t;
+
+/* The channel to subscribe to the device twin changes. */
+ZBUS_CHAN_DECLARE(device_twin_chan);
+
 /*
  * Function to construct a new device twin instance with given parameters.
  */
-device_twin_t* create_device_twin_instance(uint32_t unix_time, int8_t utc_zone);
+device_twin_t* create_device_twin_instance(int64_t unix_time_ms, uint8_t timezone_id);
 
 /*
  * Factory method to get the existing or newly constructed singleton device twin instance.
+ * Do not access its fields directly, use the snapshot and write functions below.
  */
 device_twin_t* get_device_twin_instance(void);
 
+/*
+ * Copy a consistent snapshot of the device twin. It never blocks, and is safe to call from ISRs,
+ * threads and the Bluetooth stack. Returns 0 on success, -ENODEV if the twin is not created.
+ */
+int device_twin_snapshot(device_twin_t* snapshot);
+
+/*
+ * Start writing to the device twin. It returns the twin to be modified in place. The write must be
+ * short, and finished with device_twin_write_commit() using the same key.
+ */
+device_twin_t* device_twin_write_begin(k_spinlock_key_t* key);
+
+/*
+ * Publish the modifications started with device_twin_write_begin(). The changed fields are
+ * notified on device_twin_chan, zero means the modification is not worth a notification.
+ */
+void device_twin_write_commit(k_spinlock_key_t key, uint32_t changed_fields);
+
+/*
+ * Setters of the individual fields. Returns 0 on success, -ENODEV if the twin is not created.
+ */
+int device_twin_set_unix_time_ms(int64_t unix_time_ms);
+int device_twin_set_timezone_id(uint8_t timezone_id);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,259 @@
+/** Device Twin persistence to keep the device state over resets.
+ * The twin is stored in the settings storage (NVS partition), and restored at boot. The writes are
+ * coalesced to keep the flash wear low: a change is saved after a short delay to collect the
+ * following changes, and the ticking time is saved only periodically.
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "benchmark/benchmarkclock.h"
+#include "devicetwin/devicetwin.h"
+#include "devicetwin/persistence.h"
+#include "datetime/datetime.h"
+#include "datetime/timezone.h"
+
+/* Register a logger for this library. */
+LOG_MODULE_REGISTER(ZephyrWatch_TwinPersistence, LOG_LEVEL_INF);
+
+/* A notified change is saved after this delay, so a burst of changes costs a single write. */
+#define PERSISTENCE_SAVE_DELAY_MS (10 * MSEC_PER_SEC)
+
+/* The ticking time is saved with this period. It bounds the time lost on a reset that also stops
+ * the counter, and costs one flash write per period.
+ */
+#define PERSISTENCE_TIME_SAVE_PERIOD_MS (3600 * MSEC_PER_SEC)
+
+/* Settings keys of the stored twin. */
+#define PERSISTENCE_SETTINGS_ROOT "twin"
+#define PERSISTENCE_SETTINGS_TIME_KEY "time"
+#define PERSISTENCE_SETTINGS_TIMEZONE_KEY "tz"
+
+// The time zone is stored with its name, since the ids change with the generated table.
+#define PERSISTENCE_TIMEZONE_NAME_MAX_LEN 32
+
+/* The time is stored with the counter value it is measured at, to add the ticks elapsed since. */
+typedef struct {
+    int64_t unix_time_ms;
+    uint32_t counter_value;
+} stored_time_t;
+
+/* The loaded records. They are only applied by restore_device_twin(), since the settings are
+ * loaded once more by the Bluetooth subsystem, long after the time is restored.
+ */
+static stored_time_t loaded_time;
+static bool has_loaded_time = false;
+static char loaded_timezone_name[PERSISTENCE_TIMEZONE_NAME_MAX_LEN];
+static bool has_loaded_timezone = false;
+
+/* The changed fields waiting to be saved, and the deadline of the periodic time save. */
+static atomic_t dirty_fields = ATOMIC_INIT(0);
+static int64_t next_time_save_ms = 0;
+static bool persistence_enabled = false;
+
+/* The fields set by the restore. Their notification follows the restore after the coalescing
+ * window, and is not saved: the storage already holds them.
+ */
+static atomic_t restored_fields = ATOMIC_INIT(0);
+
+/* Statistics. */
+static uint32_t write_count = 0;
+static uint32_t restore_time_us = 0;
+
+/* Prototype definition of internal static functions. */
+static int persistence_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg);
+static void device_twin_listener_callback(const struct zbus_channel *chan);
+static void save_worker(struct k_work *work);
+static void save_time();
+static void save_timezone();
+
+SETTINGS_STATIC_HANDLER_DEFINE(twin, PERSISTENCE_SETTINGS_ROOT, NULL, persistence_settings_set, NULL, NULL);
+
+ZBUS_LISTENER_DEFINE(persistence_device_twin_listener, device_twin_listener_callback);
+ZBUS_CHAN_ADD_OBS(device_twin_chan, persistence_device_twin_listener, 0);
+
+static K_WORK_DELAYABLE_DEFINE(save_work, save_worker);
+
+/* RESTORE_DEVICE_TWIN
+ * Load the stored twin, and apply it. The drift estimate is loaded too, since the elapsed ticks
+ * of the restored time are compensated with it.
+ */
+int restore_device_twin() {
+    benchmark_clock_t start = benchmark_clock_start();
+
+    int ret = settings_subsys_init();
+    if (ret) {
+        LOG_ERR("Failed to initialize settings subsystem (ret %d).", ret);
+        return ret;
+    }
+    settings_load_subtree("drift");
+    settings_load_subtree(PERSISTENCE_SETTINGS_ROOT);
+
+    if (has_loaded_timezone) {
+        int timezone_id = timezone_find(loaded_timezone_name);
+        device_twin_t device_twin;
+        if (timezone_id < 0) {
+            LOG_WRN("Stored time zone %s is not available.", loaded_timezone_name);
+        } else {
+            // The twin only notifies the time zone if it changes.
+            if (device_twin_snapshot(&device_twin) == 0 && device_twin.timezone_id != timezone_id) {
+                atomic_or(&restored_fields, DEVICE_TWIN_FIELD_TIMEZONE);
+            }
+            device_twin_set_timezone_id((uint8_t)timezone_id);
+        }
+    }
+    if (has_loaded_time) {
+        atomic_or(&restored_fields, DEVICE_TWIN_FIELD_UNIX_TIME);
+        restore_time_base_snapshot(loaded_time.unix_time_ms, loaded_time.counter_value);
+    }
+
+    restore_time_us = benchmark_clock_elapsed_ns(start) / NSEC_PER_USEC;
+    if (!has_loaded_time && !has_loaded_timezone) {
+        LOG_INF("No stored device twin is found.");
+        return -ENOENT;
+    }
+    LOG_INF("Device twin is restored in %u us.", restore_time_us);
+    return 0;
+}
+
+/* ENABLE_DEVICE_TWIN_PERSISTENCE
+ * Start the periodic time save. The changes are saved by the device twin listener.
+ */
+int enable_device_twin_persistence() {
+    next_time_save_ms = k_uptime_get() + PERSISTENCE_TIME_SAVE_PERIOD_MS;
+    persistence_enabled = true;
+    k_work_schedule(&save_work, K_MSEC(PERSISTENCE_TIME_SAVE_PERIOD_MS));
+    LOG_DBG("Device twin persistence is enabled.");
+    return 0;
+}
+
+/* DEVICE_TWIN_PERSISTENCE_GET_STATS
+ * Report the flash writes and the restore duration.
+ */
+void device_twin_persistence_get_stats(uint32_t *writes, uint32_t *restore_us) {
+    *writes = write_count;
+    *restore_us = restore_time_us;
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* PERSISTENCE_SETTINGS_SET
+ * Settings handler to load the stored twin records.
+ */
+static int persistence_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+    const char *next;
+    int ret;
+
+    if (settings_name_steq(name, PERSISTENCE_SETTINGS_TIME_KEY, &next) && !next) {
+        if (len != sizeof(loaded_time)) return -EINVAL;
+
+        ret = read_cb(cb_arg, &loaded_time, sizeof(loaded_time));
+        if (ret < 0) return ret;
+
+        has_loaded_time = true;
+        return 0;
+    }
+
+    if (settings_name_steq(name, PERSISTENCE_SETTINGS_TIMEZONE_KEY, &next) && !next) {
+        if (len == 0 || len >= sizeof(loaded_timezone_name)) return -EINVAL;
+
+        ret = read_cb(cb_arg, loaded_timezone_name, len);
+        if (ret < 0) return ret;
+
+        loaded_timezone_name[len] = '\0';
+        has_loaded_timezone = true;
+        return 0;
+    }
+
+    return -ENOENT;
+}
+
+/* DEVICE_TWIN_LISTENER_CALLBACK
+ * Mark the changed fields to be saved, and bring the save forward to the short delay. The later
+ * changes within the delay are saved together. The first notification after the restore carries
+ * the restored fields, which are left out.
+ */
+static void device_twin_listener_callback(const struct zbus_channel *chan) {
+    const device_twin_event_t *event = zbus_chan_const_msg(chan);
+    uint32_t fields = event->changed_fields & (DEVICE_TWIN_FIELD_UNIX_TIME | DEVICE_TWIN_FIELD_TIMEZONE);
+    fields &= ~(uint32_t)atomic_clear(&restored_fields);
+
+    if (!persistence_enabled || !fields) {
+        return;
+    }
+    atomic_or(&dirty_fields, fields);
+
+    if (k_ticks_to_ms_ceil64(k_work_delayable_remaining_get(&save_work)) > PERSISTENCE_SAVE_DELAY_MS) {
+        k_work_reschedule(&save_work, K_MSEC(PERSISTENCE_SAVE_DELAY_MS));
+    }
+}
+
+/* SAVE_WORKER
+ * Save the dirty fields, and the time if its period is over. Then, wait for the next period.
+ */
+static void save_worker(struct k_work *work) {
+    uint32_t fields = (uint32_t)atomic_clear(&dirty_fields);
+    int64_t now_ms = k_uptime_get();
+
+    if (fields & DEVICE_TWIN_FIELD_TIMEZONE) {
+        save_timezone();
+    }
+    if ((fields & DEVICE_TWIN_FIELD_UNIX_TIME) || now_ms >= next_time_save_ms) {
+        save_time();
+        next_time_save_ms = now_ms + PERSISTENCE_TIME_SAVE_PERIOD_MS;
+    }
+
+    k_work_schedule(&save_work, K_MSEC(next_time_save_ms - now_ms));
+}
+
+/* SAVE_TIME
+ * Store the current time with its counter value. The device twin's time is moved to it too, as the
+ * last known time. The ticking is not notified as a change.
+ */
+static void save_time() {
+    stored_time_t record;
+    get_time_base_snapshot(&record.unix_time_ms, &record.counter_value);
+
+    k_spinlock_key_t key;
+    device_twin_t *device_twin = device_twin_write_begin(&key);
+    if (device_twin) {
+        device_twin->unix_time_ms = record.unix_time_ms;
+    }
+    device_twin_write_commit(key, 0);
+
+    int ret = settings_save_one(PERSISTENCE_SETTINGS_ROOT "/" PERSISTENCE_SETTINGS_TIME_KEY, &record, sizeof(record));
+    if (ret) {
+        LOG_ERR("Failed to save time (ret %d).", ret);
+        return;
+    }
+    write_count++;
+    LOG_DBG("Time is saved (%u writes since boot).", write_count);
+}
+
+/* SAVE_TIMEZONE
+ * Store the name of the current time zone.
+ */
+static void save_timezone() {
+    device_twin_t device_twin;
+    if (device_twin_snapshot(&device_twin)) return;
+
+    if (device_twin.timezone_id >= timezone_rule_count) return;
+    const char *name = timezone_get_name(device_twin.timezone_id);
+
+    int ret = settings_save_one(PERSISTENCE_SETTINGS_ROOT "/" PERSISTENCE_SETTINGS_TIMEZONE_KEY, name, strlen(name));
+    if (ret) {
+        LOG_ERR("Failed to save time zone (ret %d).", ret);
+        return;
+    }
+    write_count++;
+    LOG_DBG("Time zone is saved (%u writes since boot).", write_count);
+}
@@ -0,0 +1,37 @@
+/** Device Twin persistence to keep the device state over resets.
+ *
+ * @license: GNU v3
+ * @maintainer: electricalgorithm @ github
+ */
+
+#ifndef _DEVICE_TWIN_PERSISTENCE_H
+#define _DEVICE_TWIN_PERSISTENCE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Load the stored device twin and restore the time and the time zone. It must be called after the
+ * datetime subsystem is enabled. The restored fields are not saved again. Returns 0 on success,
+ * -ENOENT if nothing is stored yet.
+ */
+int restore_device_twin();
+
+/*
+ * Start saving the device twin on its changes, and the time periodically.
+ */
+int enable_device_twin_persistence();
+
+/*
+ * Get the number of the flash writes since boot, and the duration of the restore in microseconds.
+ */
+void device_twin_persistence_get_stats(uint32_t *write_count, uint32_t *restore_time_us);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -1,11 +1,17 @@
 /** Display Subsystem for ZephyrWatch.
- * Provides functions to initialize the display system.
+ * Provides functions to initialize the display system, to control the backlight's brightness, and
+ * to put the panel to sleep.
+ *
+ * Brightness fades are stepped by a work item on the system work queue, so the CPU only sets the
+ * PWM pulse at each step. The work item also blanks the panel at the end of a sleep fade. Waking up
+ * cancels it synchronously before the panel is turned on, so the panel commands are never mixed.
  *
  * @license GNU v3
  * @maintainer electricalgorithm @ github
  */
 
 #include "display/display.h"
+#include <zephyr/kernel.h>
 #include <zephyr/drivers/display.h>
 #include <zephyr/drivers/pwm.h>
 #include <zephyr/logging/log.h>
@@ -17,21 +23,55 @@ LOG_MODULE_REGISTER(ZephyrWatch_Display, LOG_LEVEL_INF);
 #define DISPLAY_DEVICE DT_ALIAS(lcddisplaydevice)
 #define DISPLAY_PWM_DEVICE DT_ALIAS(lcdpwmdevice)
 
+// The backlight's PWM period, and its brightness at boot.
+#define DISPLAY_BACKLIGHT_PERIOD_NS 500
+#define DISPLAY_DEFAULT_BRIGHTNESS 50
+
+// The interval between the PWM pulse changes of a fade.
+#define DISPLAY_FADE_STEP_MS 20
+
+typedef struct {
+    uint32_t from_pulse_ns;
+    uint32_t to_pulse_ns;
+    int64_t start_ms;
+    uint32_t duration_ms;
+    bool blank_at_end;
+} fade_t;
+
+static const struct device *display_device = DEVICE_DT_GET(DISPLAY_DEVICE);
+static const struct pwm_dt_spec backlight = PWM_DT_SPEC_GET_BY_IDX(DISPLAY_PWM_DEVICE, 0);
+
+// The brightness set by the user, and the state of the backlight and the panel. The display is
+// asleep while it is dimmed below the user's brightness too; waking up restores it.
+static uint8_t brightness_percent = DISPLAY_DEFAULT_BRIGHTNESS;
+static uint32_t pulse_ns = 0;
+static bool display_asleep = false;
+static bool display_blanked = true;
+
+// The running fade. It is only changed while the fade work is cancelled.
+static fade_t fade;
+
+// Prototype definition of internal static functions.
+static void fade_worker(struct k_work *work);
+static void start_fade(uint32_t to_pulse_ns, uint32_t duration_ms, bool blank_at_end);
+static void cancel_fade();
+static int set_pulse(uint32_t new_pulse_ns);
+static uint32_t percent_to_pulse(uint8_t percent);
+static K_WORK_DELAYABLE_DEFINE(fade_work, fade_worker);
+
 /* ENABLE_DISPLAY_SUBSYSTEM
  * Set the Zephyr display device and set backlight.
  */
 int enable_display_subsystem() {
     int ret;
 
-    const struct device *display_dev = DEVICE_DT_GET(DISPLAY_DEVICE);
-    ret = device_is_ready(display_dev);
+    ret = device_is_ready(display_device);
     if (!ret) {
         LOG_ERR("Display device is not ready, exiting... (RET: %d)", ret);
         return 1;
     }
     LOG_DBG("Display device is ready.");
 
-    const struct pwm_dt_spec backlight = PWM_DT_SPEC_GET_BY_IDX(DISPLAY_PWM_DEVICE, 0);
     ret = pwm_is_ready_dt(&backlight);
     if (!ret) {
         LOG_ERR("PWM device is not ready, exiting... (RET: %d)", ret);
@@ -39,36 +79,227 @@ int enable_display_subsystem() {
     }
     LOG_DBG("PWM device is ready.");
 
-    ret = pwm_set_dt(&backlight, 500, 250);
+    ret = set_pulse(percent_to_pulse(brightness_percent));
     if (ret) {
         LOG_ERR("Failed to set PWM pulse, exiting... (RET: %d)", ret);
         return ret;
     }
     LOG_DBG("PWM pulse for LCD backlight set.");
 
-    ret = display_blanking_off(display_dev);
+    ret = display_blanking_off(display_device);
     if (ret) {
         LOG_ERR("Failed to set blanking off, exiting... (RET: %d)", ret);
         return ret;
     }
+    display_blanked = false;
+    display_asleep = false;
     LOG_DBG("Set the blanking off.");
 
     return 0;
 }
 
 
-/* ENABLE_DISPLAY_SUBSYSTEM
- * Disable the Zephyr display device and set backlight to 0.
+/* DISABLE_DISPLAY_SUBSYSTEM
+ * Turn the backlight off and blank the display right away. No flush may be in progress.
  */
 int disable_display_subsystem() {
-    LOG_DBG("Not implemented yet.");
+    int ret;
+
+    cancel_fade();
+    display_asleep = true;
+
+    ret = set_pulse(0);
+    if (ret) {
+        LOG_ERR("Failed to turn the backlight off. (RET: %d)", ret);
+        return ret;
+    }
+
+    ret = display_blanking_on(display_device);
+    if (ret) {
+        LOG_ERR("Failed to set blanking on. (RET: %d)", ret);
+        return ret;
+    }
+    display_blanked = true;
+    LOG_DBG("Display is disabled.");
     return 0;
 }
 
 /* CHANGE_BRIGHTNESS
- * Change the brightness based on a percentage.
+ * Change the brightness based on a percentage. It is applied right away unless the display sleeps,
+ * and it is restored when the display wakes up.
  */
 int change_brightness(uint8_t perc) {
-    LOG_DBG("Not implemented yet.");
+    if (perc > 100) {
+        return -EINVAL;
+    }
+
+    cancel_fade();
+    brightness_percent = perc;
+    if (display_asleep) {
+        return 0;
+    }
+    return set_pulse(percent_to_pulse(perc));
+}
+
+/* FADE_BRIGHTNESS
+ * Change the brightness based on a percentage, ramping the backlight to it in the given time.
+ */
+int fade_brightness(uint8_t perc, uint32_t duration_ms) {
+    if (perc > 100) {
+        return -EINVAL;
+    }
+
+    cancel_fade();
+    brightness_percent = perc;
+    if (!display_asleep) {
+        start_fade(percent_to_pulse(perc), duration_ms, false);
+    }
+    return 0;
+}
+
+/* GET_BRIGHTNESS
+ * Return the brightness set by the user in percentage.
+ */
+uint8_t get_brightness() {
+    return brightness_percent;
+}
+
+/* DISPLAY_SLEEP
+ * Fade the backlight out in the given time, and blank the panel at the end of it. The caller stops
+ * the flushes before.
+ */
+int display_sleep(uint32_t fade_ms) {
+    cancel_fade();
+    if (display_asleep) {
+        return 0;
+    }
+
+    display_asleep = true;
+    start_fade(0, fade_ms, true);
+    LOG_DBG("Display goes to sleep.");
     return 0;
-}
\ No newline at end of file
+}
+
+/* DISPLAY_DIM
+ * Fade the backlight to the given percentage in the given time, keeping the panel on and the user's
+ * brightness to restore when the display wakes up.
+ */
+int display_dim(uint8_t perc, uint32_t fade_ms) {
+    if (perc > 100) {
+        return -EINVAL;
+    }
+
+    cancel_fade();
+    if (display_blanked) {
+        int ret = display_blanking_off(display_device);
+        if (ret) {
+            LOG_ERR("Failed to set blanking off. (RET: %d)", ret);
+            return ret;
+        }
+        display_blanked = false;
+    }
+    display_asleep = true;
+    start_fade(percent_to_pulse(perc), fade_ms, false);
+    LOG_DBG("Display is dimmed to %u%%.", perc);
+    return 0;
+}
+
+/* DISPLAY_WAKE
+ * Turn the panel on, and fade the backlight in to the user's brightness in the given time. If the
+ * display is still fading out, it fades back from where it is.
+ */
+int display_wake(uint32_t fade_ms) {
+    cancel_fade();
+    if (!display_asleep) {
+        return 0;
+    }
+
+    if (display_blanked) {
+        int ret = display_blanking_off(display_device);
+        if (ret) {
+            LOG_ERR("Failed to set blanking off. (RET: %d)", ret);
+            return ret;
+        }
+        display_blanked = false;
+    }
+    display_asleep = false;
+    start_fade(percent_to_pulse(brightness_percent), fade_ms, false);
+    LOG_DBG("Display wakes up.");
+    return 0;
+}
+
+/* IS_DISPLAY_ASLEEP
+ * Return whether the display sleeps, fades out to sleep, or is dimmed.
+ */
+bool is_display_asleep() {
+    return display_asleep;
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* FADE_WORKER
+ * Set the pulse of the fade at the current time, and schedule the next step until the fade ends.
+ * At the end of a sleep fade, the panel is blanked.
+ */
+static void fade_worker(struct k_work *work) {
+    int64_t elapsed_ms = k_uptime_get() - fade.start_ms;
+
+    if (elapsed_ms < fade.duration_ms) {
+        int64_t delta_ns = (int64_t)fade.to_pulse_ns - fade.from_pulse_ns;
+        set_pulse(fade.from_pulse_ns + delta_ns * elapsed_ms / fade.duration_ms);
+        k_work_reschedule(&fade_work, K_MSEC(DISPLAY_FADE_STEP_MS));
+        return;
+    }
+
+    set_pulse(fade.to_pulse_ns);
+    if (fade.blank_at_end && !display_blanked) {
+        int ret = display_blanking_on(display_device);
+        if (ret) {
+            LOG_ERR("Failed to set blanking on. (RET: %d)", ret);
+            return;
+        }
+        display_blanked = true;
+    }
+}
+
+/* START_FADE
+ * Start a fade from the current pulse. The fade work must be cancelled before.
+ */
+static void start_fade(uint32_t to_pulse_ns, uint32_t duration_ms, bool blank_at_end) {
+    fade.from_pulse_ns = pulse_ns;
+    fade.to_pulse_ns = to_pulse_ns;
+    fade.start_ms = k_uptime_get();
+    fade.duration_ms = duration_ms;
+    fade.blank_at_end = blank_at_end;
+    k_work_reschedule(&fade_work, K_NO_WAIT);
+}
+
+/* CANCEL_FADE
+ * Stop the running fade where it is, and wait for its step if it is running.
+ */
+static void cancel_fade() {
+    struct k_work_sync sync;
+    k_work_cancel_delayable_sync(&fade_work, &sync);
+}
+
+/* SET_PULSE
+ * Set the backlight's PWM pulse, and remember it as the start of the next fade.
+ */
+static int set_pulse(uint32_t new_pulse_ns) {
+    int ret = pwm_set_dt(&backlight, DISPLAY_BACKLIGHT_PERIOD_NS, new_pulse_ns);
+    if (ret) {
+        LOG_ERR("Failed to set the backlight pulse to %u ns. (RET: %d)", new_pulse_ns, ret);
+        return ret;
+    }
+    pulse_ns = new_pulse_ns;
+    return 0;
+}
+
+/* PERCENT_TO_PULSE
+ * Convert the brightness percentage to the backlight's PWM pulse.
+ */
+static uint32_t percent_to_pulse(uint8_t percent) {
+    return DISPLAY_BACKLIGHT_PERIOD_NS * percent / 100;
+}
@@ -1,5 +1,6 @@
 /** Display Subsystem for ZephyrWatch.
- * Provides functions to initialize the display system.
+ * Provides functions to initialize the display system, to control the backlight's brightness, and
+ * to put the panel to sleep.
  *
  * @license GNU v3
  * @maintainer electricalgorithm @ github
@@ -8,6 +9,7 @@
 #ifndef _DISPLAY_H
 #define _DISPLAY_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -16,7 +18,23 @@ extern "C" {
 
 int enable_display_subsystem();
 int disable_display_subsystem();
+
+/* Set the backlight's brightness in percentage, right away or with a fade in the given time. */
 int change_brightness(uint8_t perc);
+int fade_brightness(uint8_t perc, uint32_t duration_ms);
+uint8_t get_brightness();
+
+/* Fade the backlight out and blank the panel, or turn the panel on and fade the backlight in to
+ * the brightness. No flush may be in progress while the display goes to sleep.
+ */
+int display_sleep(uint32_t fade_ms);
+int display_wake(uint32_t fade_ms);
+
+/* Fade the backlight to the percentage, keeping the panel on. It counts as asleep, so waking up
+ * restores the brightness.
+ */
+int display_dim(uint8_t perc, uint32_t fade_ms);
+bool is_display_asleep();
 
 #ifdef __cplusplus
 } // extern "C"
@@ -0,0 +1,200 @@
+/** RGB565 Pixel Kernels for ZephyrWatch.
+ * The swap and the fill handle a 16-bit pixel at the head of the buffer if it is not 32-bit
+ * aligned, then work on two pixels per word, and finish with the scalar routine for the odd pixel.
+ *
+ * The blends expand a pixel into a word as 00000GGG GGG00000 RRRRR000 00BBBBB, so all three
+ * channels are multiplied with the 5-bit opacity at once, each with room for its product. The
+ * opacity is rounded to 5 bits like LVGL's own RGB565 mix.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "display/rgb565.h"
+
+#define RGB565_EXPANDED_MASK 0x07E0F81FU
+#define RGB565_OPACITY_SHIFT 5
+#define RGB565_OPACITY_MAX (1U << RGB565_OPACITY_SHIFT)
+
+/* Prototype definition of internal static functions. */
+static inline uint32_t swap_pair(uint32_t pair);
+static inline uint32_t expand(uint16_t pixel);
+static inline uint16_t compact(uint32_t expanded);
+static inline uint32_t to_opacity5(uint8_t opacity);
+static inline bool is_word_aligned(const void *pointer);
+
+/* RGB565_SWAP
+ * Swap the bytes of two pixels per word, unrolled to four pixels per iteration.
+ */
+void rgb565_swap(uint16_t *pixels, uint32_t count) {
+    if (count && !is_word_aligned(pixels)) {
+        rgb565_swap_scalar(pixels, 1);
+        pixels++;
+        count--;
+    }
+
+    uint32_t *pairs = (uint32_t *)pixels;
+    uint32_t pair_count = count / 2;
+    uint32_t i = 0;
+    for (; i + 2 <= pair_count; i += 2) {
+        pairs[i] = swap_pair(pairs[i]);
+        pairs[i + 1] = swap_pair(pairs[i + 1]);
+    }
+    if (i < pair_count) {
+        pairs[i] = swap_pair(pairs[i]);
+    }
+    rgb565_swap_scalar(pixels + pair_count * 2, count % 2);
+}
+
+/* RGB565_SWAP_SCALAR
+ * Swap the bytes of each pixel.
+ */
+void rgb565_swap_scalar(uint16_t *pixels, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        pixels[i] = (uint16_t)((pixels[i] << 8) | (pixels[i] >> 8));
+    }
+}
+
+/* RGB565_FILL
+ * Store the color twice per word, unrolled to eight pixels per iteration.
+ */
+void rgb565_fill(uint16_t *pixels, uint32_t count, uint16_t color) {
+    if (count && !is_word_aligned(pixels)) {
+        *pixels++ = color;
+        count--;
+    }
+
+    uint32_t *pairs = (uint32_t *)pixels;
+    uint32_t pair = ((uint32_t)color << 16) | color;
+    uint32_t pair_count = count / 2;
+    uint32_t i = 0;
+    for (; i + 4 <= pair_count; i += 4) {
+        pairs[i] = pair;
+        pairs[i + 1] = pair;
+        pairs[i + 2] = pair;
+        pairs[i + 3] = pair;
+    }
+    for (; i < pair_count; i++) {
+        pairs[i] = pair;
+    }
+    rgb565_fill_scalar(pixels + pair_count * 2, count % 2, color);
+}
+
+/* RGB565_FILL_SCALAR
+ * Store the color to each pixel.
+ */
+void rgb565_fill_scalar(uint16_t *pixels, uint32_t count, uint16_t color) {
+    for (uint32_t i = 0; i < count; i++) {
+        pixels[i] = color;
+    }
+}
+
+/* RGB565_BLEND_COLOR
+ * The color's share of the blend is the same for every pixel, so it is multiplied once, and each
+ * pixel needs one multiplication for all of its channels.
+ */
+void rgb565_blend_color(uint16_t *pixels, uint32_t count, uint16_t color, uint8_t opacity) {
+    uint32_t alpha = to_opacity5(opacity);
+    if (alpha == 0) {
+        return;
+    }
+    if (alpha == RGB565_OPACITY_MAX) {
+        rgb565_fill(pixels, count, color);
+        return;
+    }
+
+    uint32_t color_share = expand(color) * alpha;
+    uint32_t inverse_alpha = RGB565_OPACITY_MAX - alpha;
+    for (uint32_t i = 0; i < count; i++) {
+        pixels[i] = compact((color_share + expand(pixels[i]) * inverse_alpha) >> RGB565_OPACITY_SHIFT);
+    }
+}
+
+/* RGB565_BLEND_COLOR_SCALAR
+ * Blend each channel of each pixel on its own.
+ */
+void rgb565_blend_color_scalar(uint16_t *pixels, uint32_t count, uint16_t color, uint8_t opacity) {
+    for (uint32_t i = 0; i < count; i++) {
+        rgb565_blend_scalar(&pixels[i], &color, 1, opacity);
+    }
+}
+
+/* RGB565_BLEND
+ * Blend the expanded source and destination pixels, with one multiplication for each.
+ */
+void rgb565_blend(uint16_t *destination, const uint16_t *source, uint32_t count, uint8_t opacity) {
+    uint32_t alpha = to_opacity5(opacity);
+    if (alpha == 0) {
+        return;
+    }
+    if (alpha == RGB565_OPACITY_MAX) {
+        for (uint32_t i = 0; i < count; i++) {
+            destination[i] = source[i];
+        }
+        return;
+    }
+
+    uint32_t inverse_alpha = RGB565_OPACITY_MAX - alpha;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t blended = expand(source[i]) * alpha + expand(destination[i]) * inverse_alpha;
+        destination[i] = compact(blended >> RGB565_OPACITY_SHIFT);
+    }
+}
+
+/* RGB565_BLEND_SCALAR
+ * Blend each channel of each pixel on its own.
+ */
+void rgb565_blend_scalar(uint16_t *destination, const uint16_t *source, uint32_t count, uint8_t opacity) {
+    uint32_t alpha = to_opacity5(opacity);
+    uint32_t inverse_alpha = RGB565_OPACITY_MAX - alpha;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t red = ((source[i] >> 11) * alpha + (destination[i] >> 11) * inverse_alpha) >> RGB565_OPACITY_SHIFT;
+        uint32_t green = (((source[i] >> 5) & 0x3F) * alpha + ((destination[i] >> 5) & 0x3F) * inverse_alpha) >>
+                         RGB565_OPACITY_SHIFT;
+        uint32_t blue = ((source[i] & 0x1F) * alpha + (destination[i] & 0x1F) * inverse_alpha) >>
+                        RGB565_OPACITY_SHIFT;
+        destination[i] = (uint16_t)((red << 11) | (green << 5) | blue);
+    }
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* SWAP_PAIR
+ * Swap the bytes of both pixels in the word.
+ */
+static inline uint32_t swap_pair(uint32_t pair) {
+    return ((pair & 0x00FF00FFU) << 8) | ((pair >> 8) & 0x00FF00FFU);
+}
+
+/* EXPAND
+ * Spread the channels of the pixel in a word, with a gap above each of them.
+ */
+static inline uint32_t expand(uint16_t pixel) {
+    return (pixel | ((uint32_t)pixel << 16)) & RGB565_EXPANDED_MASK;
+}
+
+/* COMPACT
+ * Pack the channels of an expanded pixel back into a pixel.
+ */
+static inline uint16_t compact(uint32_t expanded) {
+    expanded &= RGB565_EXPANDED_MASK;
+    return (uint16_t)(expanded | (expanded >> 16));
+}
+
+/* TO_OPACITY5
+ * Round the 8-bit opacity to 5 bits, from 0 (transparent) to 32 (opaque).
+ */
+static inline uint32_t to_opacity5(uint8_t opacity) {
+    return ((uint32_t)opacity + 4) >> 3;
+}
+
+/* IS_WORD_ALIGNED
+ * Check whether the pointer can be accessed as 32-bit words.
+ */
+static inline bool is_word_aligned(const void *pointer) {
+    return ((uintptr_t)pointer & (sizeof(uint32_t) - 1)) == 0;
+}
@@ -0,0 +1,40 @@
+/** RGB565 Pixel Kernels for ZephyrWatch.
+ * Byte swap, solid fill and alpha blend routines for RGB565 buffers. The default routines work on
+ * 32-bit words: the swap and the fill on two pixels per word, the blends on all channels of a
+ * pixel at once. The scalar versions work channel by channel and pixel by pixel; they are the
+ * references of the default routines, which give the same results.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _DISPLAY_RGB565_H
+#define _DISPLAY_RGB565_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Swap the bytes of each pixel, e.g. to send them to a big-endian panel. */
+void rgb565_swap(uint16_t *pixels, uint32_t count);
+void rgb565_swap_scalar(uint16_t *pixels, uint32_t count);
+
+/* Fill the pixels with the color. */
+void rgb565_fill(uint16_t *pixels, uint32_t count, uint16_t color);
+void rgb565_fill_scalar(uint16_t *pixels, uint32_t count, uint16_t color);
+
+/* Blend the color over the pixels with the opacity (0-255). */
+void rgb565_blend_color(uint16_t *pixels, uint32_t count, uint16_t color, uint8_t opacity);
+void rgb565_blend_color_scalar(uint16_t *pixels, uint32_t count, uint16_t color, uint8_t opacity);
+
+/* Blend the source pixels over the destination pixels with the opacity (0-255). */
+void rgb565_blend(uint16_t *destination, const uint16_t *source, uint32_t count, uint8_t opacity);
+void rgb565_blend_scalar(uint16_t *destination, const uint16_t *source, uint32_t count, uint8_t opacity);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,124 @@
+/** RGB565 Kernel Benchmark for ZephyrWatch.
+ * Each kernel is run on a full-width band, as many times as a second of 60 FPS needs, split into
+ * rounds. The fastest round gives the throughput, so an interrupt or a preempting host process does
+ * not count.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <zephyr/kernel.h>
+
+#include "benchmark/benchmarkclock.h"
+#include "display/rgb565.h"
+#include "display/rgb565benchmark.h"
+
+#define BENCHMARK_PIXELS (240 * 24)
+#define BENCHMARK_ROUNDS 5
+#define BENCHMARK_RUNS_PER_ROUND 120
+
+// The arguments of the fill and the blends.
+#define BENCHMARK_COLOR 0x1234
+#define BENCHMARK_OPACITY 128
+
+typedef struct {
+    const char *name;
+    void (*kernel)();
+    void (*kernel_scalar)();
+} kernel_benchmark_t;
+
+static uint16_t destination[BENCHMARK_PIXELS] __aligned(4);
+static uint16_t source[BENCHMARK_PIXELS] __aligned(4);
+
+/* Prototype definition of internal static functions. */
+static uint32_t measure_throughput(void (*kernel)());
+static void swap_kernel();
+static void swap_kernel_scalar();
+static void fill_kernel();
+static void fill_kernel_scalar();
+static void blend_color_kernel();
+static void blend_color_kernel_scalar();
+static void blend_kernel();
+static void blend_kernel_scalar();
+
+static const kernel_benchmark_t benchmarks[RGB565_BENCHMARK_KERNEL_COUNT] = {
+    { "Swap", swap_kernel, swap_kernel_scalar },
+    { "Fill", fill_kernel, fill_kernel_scalar },
+    { "Blend color", blend_color_kernel, blend_color_kernel_scalar },
+    { "Blend image", blend_kernel, blend_kernel_scalar },
+};
+
+/* RGB565_BENCHMARK_PIXEL
+ * Multiply the index with Knuth's multiplicative hash constant, and take the upper half.
+ */
+uint16_t rgb565_benchmark_pixel(uint32_t index) {
+    return (uint16_t)(index * 2654435761U >> 16);
+}
+
+/* RGB565_BENCHMARK_RUN
+ * Fill the source band, and measure each kernel and its scalar version.
+ */
+void rgb565_benchmark_run(rgb565_benchmark_result_t results[RGB565_BENCHMARK_KERNEL_COUNT]) {
+    for (uint32_t i = 0; i < BENCHMARK_PIXELS; i++) {
+        source[i] = rgb565_benchmark_pixel(i);
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(benchmarks); i++) {
+        results[i].name = benchmarks[i].name;
+        results[i].throughput = measure_throughput(benchmarks[i].kernel);
+        results[i].throughput_scalar = measure_throughput(benchmarks[i].kernel_scalar);
+    }
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* MEASURE_THROUGHPUT
+ * Run the kernel on the band, and return the destination bytes it writes per microsecond, i.e. MB/s,
+ * in its fastest round.
+ */
+static uint32_t measure_throughput(void (*kernel)()) {
+    uint64_t fastest_round_ns = UINT64_MAX;
+    for (uint32_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+        benchmark_clock_t start = benchmark_clock_start();
+        for (uint32_t run = 0; run < BENCHMARK_RUNS_PER_ROUND; run++) {
+            kernel();
+        }
+        fastest_round_ns = MIN(fastest_round_ns, benchmark_clock_elapsed_ns(start));
+    }
+    uint64_t bytes = (uint64_t)sizeof(destination) * BENCHMARK_RUNS_PER_ROUND;
+    return bytes * NSEC_PER_USEC / MAX(fastest_round_ns, 1);
+}
+
+/* The kernels with the band and the arguments of the benchmark. */
+static void swap_kernel() {
+    rgb565_swap(destination, BENCHMARK_PIXELS);
+}
+
+static void swap_kernel_scalar() {
+    rgb565_swap_scalar(destination, BENCHMARK_PIXELS);
+}
+
+static void fill_kernel() {
+    rgb565_fill(destination, BENCHMARK_PIXELS, BENCHMARK_COLOR);
+}
+
+static void fill_kernel_scalar() {
+    rgb565_fill_scalar(destination, BENCHMARK_PIXELS, BENCHMARK_COLOR);
+}
+
+static void blend_color_kernel() {
+    rgb565_blend_color(destination, BENCHMARK_PIXELS, BENCHMARK_COLOR, BENCHMARK_OPACITY);
+}
+
+static void blend_color_kernel_scalar() {
+    rgb565_blend_color_scalar(destination, BENCHMARK_PIXELS, BENCHMARK_COLOR, BENCHMARK_OPACITY);
+}
+
+static void blend_kernel() {
+    rgb565_blend(destination, source, BENCHMARK_PIXELS, BENCHMARK_OPACITY);
+}
+
+static void blend_kernel_scalar() {
+    rgb565_blend_scalar(destination, source, BENCHMARK_PIXELS, BENCHMARK_OPACITY);
+}
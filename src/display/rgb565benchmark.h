@@ -0,0 +1,39 @@
+/** RGB565 Kernel Benchmark for ZephyrWatch.
+ * Measures the throughput of the RGB565 kernels and of their scalar versions on a full-width band
+ * of the screen. It is shared by the display benchmark and the kernels' tests.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _DISPLAY_RGB565BENCHMARK_H
+#define _DISPLAY_RGB565BENCHMARK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The swap, the fill, the color blend and the image blend.
+#define RGB565_BENCHMARK_KERNEL_COUNT 4
+
+typedef struct {
+    const char *name;
+    uint32_t throughput;         // MB/s of the word-wide kernel.
+    uint32_t throughput_scalar;  // MB/s of its scalar version.
+} rgb565_benchmark_result_t;
+
+/* Return a pixel of a fixed pseudo-random sequence, which covers all bits of the channels. */
+uint16_t rgb565_benchmark_pixel(uint32_t index);
+
+/* Measure the kernels, in the order of RGB565_BENCHMARK_KERNEL_COUNT. It takes a few seconds on the
+ * watch.
+ */
+void rgb565_benchmark_run(rgb565_benchmark_result_t results[RGB565_BENCHMARK_KERNEL_COUNT]);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
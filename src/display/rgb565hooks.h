@@ -0,0 +1,61 @@
+/** RGB565 Draw Hooks for ZephyrWatch.
+ * LVGL's software renderer includes this file as its custom assembly header (see CMakeLists.txt),
+ * and calls the hooks below instead of its own loops for opaque solid fills, translucent solid
+ * fills and translucent RGB565 images. The masked cases are left to LVGL.
+ *
+ * It is compiled with LVGL's sources, so it only uses what the blend files include.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _DISPLAY_RGB565HOOKS_H
+#define _DISPLAY_RGB565HOOKS_H
+
+#include "rgb565.h"
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                                                          \
+    rgb565_hook_fill((dsc)->dest_buf, (dsc)->dest_w, (dsc)->dest_h, (dsc)->dest_stride,               \
+                     lv_color_to_u16((dsc)->color), LV_OPA_COVER)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)                                                 \
+    rgb565_hook_fill((dsc)->dest_buf, (dsc)->dest_w, (dsc)->dest_h, (dsc)->dest_stride,               \
+                     lv_color_to_u16((dsc)->color), (dsc)->opa)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)                                         \
+    rgb565_hook_blend((dsc)->dest_buf, (dsc)->dest_w, (dsc)->dest_h, (dsc)->dest_stride,              \
+                      (dsc)->src_buf, (dsc)->src_stride, (dsc)->opa)
+
+/* RGB565_HOOK_FILL
+ * Fill or blend the color to each row of the area. The stride is in bytes.
+ */
+static inline lv_result_t rgb565_hook_fill(void *buffer, int32_t width, int32_t height, int32_t stride,
+                                           uint16_t color, lv_opa_t opacity) {
+    uint8_t *row = buffer;
+    for (int32_t y = 0; y < height; y++) {
+        if (opacity >= LV_OPA_MAX) {
+            rgb565_fill((uint16_t *)row, width, color);
+        } else {
+            rgb565_blend_color((uint16_t *)row, width, color, opacity);
+        }
+        row += stride;
+    }
+    return LV_RESULT_OK;
+}
+
+/* RGB565_HOOK_BLEND
+ * Blend each row of the source image to the area. The strides are in bytes.
+ */
+static inline lv_result_t rgb565_hook_blend(void *buffer, int32_t width, int32_t height, int32_t stride,
+                                            const void *source, int32_t source_stride, lv_opa_t opacity) {
+    uint8_t *row = buffer;
+    const uint8_t *source_row = source;
+    for (int32_t y = 0; y < height; y++) {
+        rgb565_blend((uint16_t *)row, (const uint16_t *)source_row, width, opacity);
+        row += stride;
+        source_row += source_stride;
+    }
+    return LV_RESULT_OK;
+}
+
+#endif
@@ -0,0 +1,281 @@
+/** Round Display Flush for ZephyrWatch.
+ * The GC9A01 is a round panel on a square frame memory, so about 21% of a full-width area is
+ * outside the visible circle. Each flushed area is clipped row by row to the circle, and only the
+ * visible spans are written with their own window address. Consecutive rows are merged into a
+ * single window while the invisible pixels it adds cost less than the address commands of a new
+ * window.
+ *
+ * The panel driver sends a buffer in one transfer only if its pitch is its width, and otherwise one
+ * transfer per row. Each window's rows are packed in place at the start of the window in the draw
+ * buffer, since LVGL renders the next area over the buffer anyway, so a window is one transfer.
+ *
+ * With two draw buffers, the windows are written by a flush thread. LVGL renders the next band into
+ * the other buffer while the SPI transfer of the current band runs, and waits for it only when it
+ * needs the buffer again.
+ *
+ * If LVGL's RGB565 has to be byte-swapped for the panel, only the windows are swapped, after they
+ * are packed.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/logging/log.h>
+
+#include "display/rgb565.h"
+#include "display/roundflush.h"
+
+// Get a logger for the round flush.
+LOG_MODULE_REGISTER(ZephyrWatch_RoundFlush, LOG_LEVEL_INF);
+
+// Get devices from the device tree.
+#define DISPLAY_DEVICE DT_ALIAS(lcddisplaydevice)
+
+// The largest supported panel.
+#define ROUND_FLUSH_MAX_SIZE 240
+
+/* The cost of a new window in pixels: the column, row and memory write commands (11 bytes) and the
+ * set-up of their transfers. A row is merged into the current window if it adds fewer pixels.
+ */
+#define ROUND_FLUSH_WINDOW_COST_PIXELS 16
+
+#define ROUND_FLUSH_BYTES_PER_PIXEL 2
+
+// The flush thread. The transfers of the bands are queued to it, one per draw buffer.
+#define ROUND_FLUSH_THREAD_STACK_SIZE 2048
+#define ROUND_FLUSH_THREAD_PRIORITY K_PRIO_COOP(1)
+#define ROUND_FLUSH_QUEUE_LENGTH 2
+#define ROUND_FLUSH_ASYNC IS_ENABLED(CONFIG_LV_Z_DOUBLE_VDB)
+
+// The interval to check whether the queued areas are flushed.
+#define ROUND_FLUSH_WAIT_POLL_MS 1
+
+// The panel takes the pixels big-endian.
+#define ROUND_FLUSH_SWAP_BYTES IS_ENABLED(CONFIG_LV_COLOR_16_SWAP)
+
+typedef struct {
+    lv_display_t *display;
+    lv_area_t area;
+    uint8_t *px_map;
+} flush_request_t;
+
+static const struct device *display_device = DEVICE_DT_GET(DISPLAY_DEVICE);
+
+// The first and the last visible column of each row.
+static uint8_t span_start[ROUND_FLUSH_MAX_SIZE];
+static uint8_t span_end[ROUND_FLUSH_MAX_SIZE];
+
+static round_flush_stats_t stats;
+
+// The areas queued or being flushed by the flush thread.
+static atomic_t pending_count = ATOMIC_INIT(0);
+
+/* Prototype definition of internal static functions. */
+static void round_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
+static void flush_thread_entry(void *p1, void *p2, void *p3);
+static void flush_area(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
+static void write_window(const lv_area_t *area, uint8_t *px_map, int32_t x_start, int32_t x_end,
+                         int32_t y_start, int32_t y_end);
+static uint32_t isqrt(uint32_t value);
+
+K_MSGQ_DEFINE(flush_queue, sizeof(flush_request_t), ROUND_FLUSH_QUEUE_LENGTH, 4);
+K_THREAD_DEFINE(round_flush_thread, ROUND_FLUSH_THREAD_STACK_SIZE, flush_thread_entry, NULL, NULL, NULL,
+                ROUND_FLUSH_THREAD_PRIORITY, 0, 0);
+
+/* ROUND_FLUSH_ATTACH
+ * Compute the visible span of each row, and replace the flush callback of the display.
+ */
+int round_flush_attach(lv_display_t *display) {
+    if (!device_is_ready(display_device)) {
+        LOG_ERR("Display device is not ready.");
+        return -ENODEV;
+    }
+
+    struct display_capabilities capabilities;
+    display_get_capabilities(display_device, &capabilities);
+    uint32_t size = capabilities.x_resolution;
+    if (size != capabilities.y_resolution || size > ROUND_FLUSH_MAX_SIZE) {
+        LOG_ERR("Round flush does not support %ux%u panels.", capabilities.x_resolution,
+                capabilities.y_resolution);
+        return -ENOTSUP;
+    }
+
+    /* A pixel is visible if its center is inside the circle. In doubled coordinates, the center of
+     * pixel x is 2x+1, the center of the circle is size, and the radius is size.
+     */
+    for (uint32_t y = 0; y < size; y++) {
+        int32_t dy = (int32_t)(2 * y + 1) - (int32_t)size;
+        uint32_t half_span = isqrt(size * size - dy * dy);
+        span_start[y] = (size - half_span) / 2;
+        span_end[y] = (size + half_span - 1) / 2;
+    }
+
+    lv_display_set_flush_cb(display, round_flush_cb);
+    LOG_DBG("Round flush is attached for %ux%u.", size, size);
+    return 0;
+}
+
+/* ROUND_FLUSH_GET_STATS
+ * Copy the transfer statistics.
+ */
+void round_flush_get_stats(round_flush_stats_t *copy) {
+    *copy = stats;
+}
+
+/* ROUND_FLUSH_RESET_STATS
+ * Reset the transfer statistics.
+ */
+void round_flush_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+/* ROUND_FLUSH_WAIT
+ * Wait until the queued areas are written to the panel.
+ */
+void round_flush_wait() {
+    while (atomic_get(&pending_count) > 0) {
+        k_msleep(ROUND_FLUSH_WAIT_POLL_MS);
+    }
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* ROUND_FLUSH_CB
+ * Queue the area to the flush thread if there is another draw buffer to render into meanwhile.
+ * Otherwise, flush it right away.
+ */
+static void round_flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map) {
+    if (ROUND_FLUSH_ASYNC) {
+        flush_request_t request = { .display = display, .area = *area, .px_map = px_map };
+        atomic_inc(&pending_count);
+        k_msgq_put(&flush_queue, &request, K_FOREVER);
+        return;
+    }
+    flush_area(display, area, px_map);
+}
+
+/* FLUSH_THREAD_ENTRY
+ * Flush the queued areas in order. LVGL is told the buffer is free after each of them.
+ */
+static void flush_thread_entry(void *p1, void *p2, void *p3) {
+    flush_request_t request;
+    while (true) {
+        k_msgq_get(&flush_queue, &request, K_FOREVER);
+        flush_area(request.display, &request.area, request.px_map);
+        atomic_dec(&pending_count);
+    }
+}
+
+/* FLUSH_AREA
+ * Clip each row of the area to the circle, merge the rows into windows, and write them.
+ */
+static void flush_area(lv_display_t *display, const lv_area_t *area, uint8_t *px_map) {
+    int32_t window_start = 0, window_end = -1, window_y = 0;
+    bool window_open = false;
+    uint32_t visible_pixels = 0;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        int32_t row_start = MAX(area->x1, span_start[y]);
+        int32_t row_end = MIN(area->x2, span_end[y]);
+        bool row_visible = row_start <= row_end;
+
+        // Extend the window with the row if the pixels it adds to the window cost less than a new
+        // window. Widening the window adds pixels to its previous rows too.
+        if (window_open && row_visible) {
+            int32_t merged_start = MIN(window_start, row_start);
+            int32_t merged_end = MAX(window_end, row_end);
+            int32_t added_pixels = ((merged_end - merged_start) - (window_end - window_start)) * (y - window_y) +
+                                   ((merged_end - merged_start) - (row_end - row_start));
+            if (added_pixels <= ROUND_FLUSH_WINDOW_COST_PIXELS) {
+                window_start = merged_start;
+                window_end = merged_end;
+                continue;
+            }
+        }
+
+        // Otherwise, write the window and open a new one with the row.
+        if (window_open) {
+            write_window(area, px_map, window_start, window_end, window_y, y - 1);
+            visible_pixels += (window_end - window_start + 1) * (y - window_y);
+        }
+        window_open = row_visible;
+        window_start = row_start;
+        window_end = row_end;
+        window_y = y;
+    }
+    if (window_open) {
+        write_window(area, px_map, window_start, window_end, window_y, area->y2);
+        visible_pixels += (window_end - window_start + 1) * (area->y2 - window_y + 1);
+    }
+
+    stats.flush_count++;
+    stats.sent_bytes += visible_pixels * ROUND_FLUSH_BYTES_PER_PIXEL;
+    stats.skipped_bytes += (lv_area_get_size(area) - visible_pixels) * ROUND_FLUSH_BYTES_PER_PIXEL;
+    lv_display_flush_ready(display);
+}
+
+/* WRITE_WINDOW
+ * Write the part of the area's buffer between the given columns and rows. The buffer keeps the
+ * area's width as its pitch, so the rows are moved next to each other first. A packed row never
+ * goes past its own source row, and the rows after the window are not touched. The rows are
+ * byte-swapped after if the panel needs it.
+ */
+static void write_window(const lv_area_t *area, uint8_t *px_map, int32_t x_start, int32_t x_end,
+                         int32_t y_start, int32_t y_end) {
+    uint32_t pitch = lv_area_get_width(area);
+    uint32_t width = x_end - x_start + 1;
+    uint32_t height = y_end - y_start + 1;
+    uint32_t row_bytes = width * ROUND_FLUSH_BYTES_PER_PIXEL;
+    uint8_t *buffer = px_map +
+        ((y_start - area->y1) * pitch + (x_start - area->x1)) * ROUND_FLUSH_BYTES_PER_PIXEL;
+
+    if (width != pitch) {
+        for (uint32_t row = 1; row < height; row++) {
+            memmove(buffer + row * row_bytes, buffer + row * pitch * ROUND_FLUSH_BYTES_PER_PIXEL, row_bytes);
+        }
+    }
+    if (ROUND_FLUSH_SWAP_BYTES) {
+        rgb565_swap((uint16_t *)buffer, width * height);
+    }
+
+    struct display_buffer_descriptor descriptor = {
+        .buf_size = height * row_bytes,
+        .width = width,
+        .height = height,
+        .pitch = width,
+    };
+    int ret = display_write(display_device, x_start, y_start, &descriptor, buffer);
+    if (ret) {
+        LOG_ERR("Failed to write the display window (ret %d).", ret);
+    }
+    stats.window_count++;
+}
+
+/* ISQRT
+ * Integer square root, rounded down.
+ */
+static uint32_t isqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1U << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
@@ -0,0 +1,45 @@
+/** Round Display Flush for ZephyrWatch.
+ * Replaces LVGL's flush with one that only sends the pixels inside the visible circle of the round
+ * panel.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _DISPLAY_ROUNDFLUSH_H
+#define _DISPLAY_ROUNDFLUSH_H
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The transfer statistics of the flushes. */
+typedef struct {
+    uint32_t flush_count;    // Areas flushed by LVGL.
+    uint32_t window_count;   // Windows written to the panel, each in one transfer.
+    uint64_t sent_bytes;     // Pixel bytes sent to the panel.
+    uint64_t skipped_bytes;  // Pixel bytes outside the circle, which are not sent.
+} round_flush_stats_t;
+
+/* Install the round flush to the LVGL display. Returns 0 on success, -ENODEV if the display device
+ * is not ready, -ENOTSUP if the panel is not square or bigger than supported.
+ */
+int round_flush_attach(lv_display_t *display);
+
+/* Wait until the areas queued to the flush thread are written, e.g. before the panel is blanked. */
+void round_flush_wait();
+
+/* Copy the transfer statistics. */
+void round_flush_get_stats(round_flush_stats_t *stats);
+
+/* Reset the transfer statistics, e.g. before a benchmark. */
+void round_flush_reset_stats();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -13,18 +13,28 @@
 #include "watchdog/watchdog.h"
 #include "display/display.h"
 #include "devicetwin/devicetwin.h"
+#include "devicetwin/persistence.h"
 #include "userinterface/userinterface.h"
+#include "userinterface/benchmark.h"
+#include "userinterface/energymodel.h"
 #include "datetime/datetime.h"
+#include "datetime/timezone.h"
+#include "datetime/scheduler.h"
 #include "bluetooth/infrastructure.h"
 
 // Define the logger.
 LOG_MODULE_REGISTER(ZephyrWatch, LOG_LEVEL_INF);
 
 #define SLEEP_UI_STABILIZE_MS 2000
-#define SLEEP_MAIN_CORE_MS 20
 
-// Setting for device's time zone.
-int8_t utc_zone = +2;
+// The period of the idle time and the energy model report.
+#define IDLE_REPORT_PERIOD_MS 60000
+
+static void idle_report_worker(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(idle_report_work, idle_report_worker);
+
+// Setting for device's default time zone. It must be one of ZEPHYRWATCH_TIMEZONES in CMakeLists.txt.
+#define DEFAULT_TIMEZONE "Europe/Berlin"
 
 int main(void) {
     int ret;
@@ -37,8 +47,15 @@ int main(void) {
     }
     LOG_INF("Watchdog system is enabled.");
 
+    // Find the default time zone in the generated time zone table.
+    int timezone_id = timezone_find(DEFAULT_TIMEZONE);
+    if (timezone_id < 0) {
+        LOG_WRN("Default time zone %s is not found, using %s.", DEFAULT_TIMEZONE, timezone_get_name(0));
+        timezone_id = 0;
+    }
+
     // Create the device twin.
-    device_twin_t* device_twin = create_device_twin_instance(0, utc_zone);
+    device_twin_t* device_twin = create_device_twin_instance(0, (uint8_t)timezone_id);
     if (!device_twin) {
         LOG_ERR("Cannot create device twin instance.");
         return 0;
@@ -61,6 +78,11 @@ int main(void) {
     user_interface_task_handler();
     LOG_INF("User interface is refreshed initally.");
 
+#ifdef ZEPHYRWATCH_DISPLAY_BENCHMARK
+    // Measure the display path before the other subsystems load the system.
+    run_display_benchmark();
+#endif
+
     // Enable datetime subsystem.
     ret = enable_datetime_subsystem();
     if (ret) {
@@ -69,6 +91,22 @@ int main(void) {
     }
     LOG_INF("Datetime subsystem is enabled.");
 
+    // Enable the wall-clock scheduler on top of the datetime subsystem.
+    ret = enable_wallclock_scheduler();
+    if (ret) {
+        LOG_ERR("Wall-clock scheduler couldn't enabled. (RET: %d)", ret);
+        return ret;
+    }
+    LOG_INF("Wall-clock scheduler is enabled.");
+
+    // Restore the last known time and time zone, and keep them saved from now on.
+    ret = restore_device_twin();
+    if (ret && ret != -ENOENT) {
+        LOG_WRN("Device twin couldn't restored. (RET: %d)", ret);
+    }
+    enable_device_twin_persistence();
+    LOG_INF("Device twin persistence is enabled.");
+
     // Initialize the Bluetooth stack.
     // Give the system more time to stabilize before initializing Bluetooth.
     k_sleep(K_MSEC(SLEEP_UI_STABILIZE_MS));
@@ -79,11 +117,36 @@ int main(void) {
     }
     LOG_INF("Bluetooth subsystem is enabled.");
 
+    // Report the share of the idle thread periodically.
+    k_work_schedule(&idle_report_work, K_MSEC(IDLE_REPORT_PERIOD_MS));
+
+    // The main thread owns LVGL. It sleeps until LVGL's next timer, or until it is woken up by a
+    // UI command or an input event. The watchdog is kicked while this loop checks in.
     while (1) {
-        user_interface_task_handler();
-        k_sleep(K_MSEC(SLEEP_MAIN_CORE_MS));
+        uint32_t next_call_ms = user_interface_task_handler();
+        user_interface_wait(next_call_ms);
+    }
+}
 
-        // Kick the watchdog.
-        kick_watchdog();
+/* IDLE_REPORT_WORKER
+ * Log the share of the idle thread in the CPU time since the previous report, and the energy model
+ * of the display modes.
+ */
+static void idle_report_worker(struct k_work *work) {
+    static uint64_t last_execution_cycles = 0;
+    static uint64_t last_idle_cycles = 0;
+
+    k_thread_runtime_stats_t stats;
+    if (k_thread_runtime_stats_all_get(&stats) == 0) {
+        uint64_t execution_cycles = stats.execution_cycles - last_execution_cycles;
+        uint64_t idle_cycles = stats.idle_cycles - last_idle_cycles;
+        if (execution_cycles > 0) {
+            LOG_INF("Idle time: %u%%.", (uint32_t)(idle_cycles * 100 / execution_cycles));
+        }
+        last_execution_cycles = stats.execution_cycles;
+        last_idle_cycles = stats.idle_cycles;
     }
-}
\ No newline at end of file
+    energy_model_log();
+
+    k_work_schedule(&idle_report_work, K_MSEC(IDLE_REPORT_PERIOD_MS));
+}
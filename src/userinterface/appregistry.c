@@ -0,0 +1,118 @@
+/** Application Registry for ZephyrWatch.
+ * The applications are kept in registration order in an array which doubles its capacity when it is
+ * full. The ids are looked up linearly; the registry is only changed at start-up and by the menu.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+
+#include "userinterface/appregistry.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_UI_AppRegistry, LOG_LEVEL_INF);
+
+// The capacity of the registry at the first registration.
+#define APP_REGISTRY_INITIAL_CAPACITY 8
+
+static application_t *applications = NULL;
+static uint32_t application_count = 0;
+static uint32_t application_capacity = 0;
+static uint32_t registry_version = 0;
+
+/* Prototype definition of internal static functions. */
+static int find_index(const char *id);
+
+/* REGISTER_APPLICATION
+ * Append the application to the registry, growing it if it is full.
+ */
+int register_application(const char *id, const char *name, lv_obj_t *screen) {
+    if (find_index(id) >= 0) {
+        LOG_WRN("Application %s is already registered.", id);
+        return -EALREADY;
+    }
+
+    if (application_count == application_capacity) {
+        uint32_t capacity = application_capacity ? application_capacity * 2 : APP_REGISTRY_INITIAL_CAPACITY;
+        application_t *grown = realloc(applications, capacity * sizeof(application_t));
+        if (grown == NULL) {
+            LOG_ERR("Application registry cannot grow to %u entries.", capacity);
+            return -ENOMEM;
+        }
+        applications = grown;
+        application_capacity = capacity;
+    }
+
+    applications[application_count].id = id;
+    applications[application_count].name = name;
+    applications[application_count].screen = screen;
+    application_count++;
+    registry_version++;
+    LOG_DBG("Application registered successfully: %s", id);
+    return 0;
+}
+
+/* UNREGISTER_APPLICATION
+ * Remove the application, and move the following ones back.
+ */
+int unregister_application(const char *id) {
+    int index = find_index(id);
+    if (index < 0) {
+        return -ENOENT;
+    }
+
+    memmove(&applications[index], &applications[index + 1],
+            (application_count - index - 1) * sizeof(application_t));
+    application_count--;
+    registry_version++;
+    LOG_DBG("Application unregistered: %s", id);
+    return 0;
+}
+
+/* FIND_APPLICATION
+ * Return the application with the id.
+ */
+const application_t* find_application(const char *id) {
+    int index = find_index(id);
+    return index < 0 ? NULL : &applications[index];
+}
+
+/* GET_APPLICATION
+ * Return the application at the index.
+ */
+const application_t* get_application(uint32_t index) {
+    return index < application_count ? &applications[index] : NULL;
+}
+
+/* GET_APPLICATION_COUNT
+ * Return the number of the registered applications.
+ */
+uint32_t get_application_count() {
+    return application_count;
+}
+
+/* GET_APPLICATION_REGISTRY_VERSION
+ * Return the version of the registry, which is increased at each change.
+ */
+uint32_t get_application_registry_version() {
+    return registry_version;
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* FIND_INDEX
+ * Return the index of the application with the id, or -1.
+ */
+static int find_index(const char *id) {
+    for (uint32_t i = 0; i < application_count; i++) {
+        if (strcmp(applications[i].id, id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,60 @@
+/** Application Registry for ZephyrWatch.
+ * Keeps the applications listed in the menu, keyed by their ids. The registry grows on the heap as
+ * applications are registered, and an id can only be registered once.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_APPREGISTRY_H
+#define _SMART_WATCH_UI_APPREGISTRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/* A registered application. The id and the name are not copied, so they must outlive the
+ * registration (e.g. string literals).
+ */
+typedef struct {
+    const char *id;
+    const char *name;
+    lv_obj_t *screen;
+} application_t;
+
+/**
+ * Register an application to be displayed in the menu. It is only called by the LVGL-owner thread.
+ * @param id The unique id of the application.
+ * @param name The name of the application to display.
+ * @param screen The screen object for the application, or NULL if it has none yet.
+ * @return 0 on success, -EALREADY if the id is registered, -ENOMEM if the registry cannot grow.
+ */
+int register_application(const char *id, const char *name, lv_obj_t *screen);
+
+/**
+ * Remove an application from the registry. The order of the others is kept.
+ * @param id The id of the application.
+ * @return 0 on success, -ENOENT if the id is not registered.
+ */
+int unregister_application(const char *id);
+
+/* Return the application with the id, or NULL if it is not registered. */
+const application_t* find_application(const char *id);
+
+/* Return the application at the index in registration order, or NULL if it is out of range. */
+const application_t* get_application(uint32_t index);
+
+/* Return the number of the registered applications. */
+uint32_t get_application_count();
+
+/* Return a number which changes each time the registry is changed. */
+uint32_t get_application_registry_version();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
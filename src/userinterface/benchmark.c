@@ -0,0 +1,181 @@
+/** Display benchmark for ZephyrWatch.
+ * Measures the display traffic of a full-screen refresh and of the home-to-menu screen load
+ * animation, and the frame times of the animation, which repaints the whole screen every frame.
+ * The home clock is redrawn from its digit atlas with all of its digits changed, then with one.
+ * The throughput of the RGB565 kernels is compared with their scalar versions on a draw band.
+ * The home-to-menu and menu-to-home slides are run with live rendering and with snapshots, and they
+ * log their frame rates.
+ * It is run at boot with the ZEPHYRWATCH_DISPLAY_BENCHMARK CMake option.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include "lvgl.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "display/rgb565benchmark.h"
+#include "display/roundflush.h"
+#include "userinterface/benchmark.h"
+#include "userinterface/screenmanager.h"
+#include "userinterface/screentransition.h"
+#include "userinterface/navigation.h"
+#include "userinterface/screens/home/home.h"
+#include "userinterface/screens/menu/menu.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_Benchmark, LOG_LEVEL_INF);
+
+// The screen load animation measured, as used by the home screen's gesture.
+#define BENCHMARK_ANIMATION_MS 300
+
+// Frame times of the measured animation.
+static uint32_t frame_start_cycles = 0;
+static uint32_t frame_count = 0;
+static uint32_t frame_time_min_us = UINT32_MAX;
+static uint32_t frame_time_max_us = 0;
+static uint64_t frame_time_total_us = 0;
+
+/* Prototype definition of internal static functions. */
+static void log_stats(const char *name, uint32_t duration_us);
+static void run_clock_benchmark();
+static void run_kernel_benchmark();
+static void run_transition_benchmark();
+static void wait_for_transition();
+static void frame_time_callback(lv_event_t *event);
+
+/* RUN_DISPLAY_BENCHMARK
+ * Redraw the whole home screen, then animate to the menu screen, and log the transfer of each.
+ * Then, measure the clock updates, the RGB565 kernels and the screen transitions.
+ */
+void run_display_benchmark() {
+    uint32_t start;
+
+    // Full-screen refresh.
+    screen_manager_show(SCREEN_HOME, LV_SCR_LOAD_ANIM_NONE, 0);
+    lv_refr_now(NULL);
+    round_flush_reset_stats();
+    start = k_cycle_get_32();
+    lv_obj_invalidate(home_screen);
+    lv_refr_now(NULL);
+    log_stats("Full-screen refresh", k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
+    // Screen load animation, run with LVGL's timers until it is finished.
+    screen_manager_get(SCREEN_MENU);
+    lv_display_t *display = lv_display_get_default();
+    lv_display_add_event_cb(display, frame_time_callback, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display, frame_time_callback, LV_EVENT_REFR_READY, NULL);
+    round_flush_reset_stats();
+    start = k_cycle_get_32();
+    screen_manager_show(SCREEN_MENU, LV_SCR_LOAD_ANIM_MOVE_TOP, BENCHMARK_ANIMATION_MS);
+    while (lv_screen_active() != menu_screen || lv_anim_count_running() > 0) {
+        k_msleep(MIN(lv_timer_handler(), LV_DEF_REFR_PERIOD));
+    }
+    lv_refr_now(NULL);
+    log_stats("Screen load animation", k_cyc_to_us_floor32(k_cycle_get_32() - start));
+    lv_display_remove_event_cb_with_user_data(display, frame_time_callback, NULL);
+
+    if (frame_count > 0) {
+        LOG_INF("Screen load animation: %u frames, frame time min %u us, avg %u us, max %u us.",
+                frame_count, frame_time_min_us, (uint32_t)(frame_time_total_us / frame_count),
+                frame_time_max_us);
+    }
+
+    screen_manager_show(SCREEN_HOME, LV_SCR_LOAD_ANIM_NONE, 0);
+    lv_refr_now(NULL);
+
+    run_clock_benchmark();
+    run_kernel_benchmark();
+    run_transition_benchmark();
+    lv_refr_now(NULL);
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* LOG_STATS
+ * Log the transfer since the last reset.
+ */
+static void log_stats(const char *name, uint32_t duration_us) {
+    round_flush_stats_t stats;
+    round_flush_get_stats(&stats);
+    LOG_INF("%s: %u flushes, %u windows, %u bytes sent, %u bytes skipped, %u us.", name,
+            stats.flush_count, stats.window_count, (uint32_t)stats.sent_bytes,
+            (uint32_t)stats.skipped_bytes, duration_us);
+}
+
+/* RUN_CLOCK_BENCHMARK
+ * Log the redraw of the home clock when all of its digits change, and when only the last one does.
+ */
+static void run_clock_benchmark() {
+    uint32_t start;
+
+    home_screen_set_clock(0, 0);
+    lv_refr_now(NULL);
+
+    round_flush_reset_stats();
+    start = k_cycle_get_32();
+    home_screen_set_clock(12, 34);
+    lv_refr_now(NULL);
+    log_stats("Clock update of 4 digits", k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
+    round_flush_reset_stats();
+    start = k_cycle_get_32();
+    home_screen_set_clock(12, 35);
+    lv_refr_now(NULL);
+    log_stats("Clock update of 1 digit", k_cyc_to_us_floor32(k_cycle_get_32() - start));
+}
+
+/* RUN_KERNEL_BENCHMARK
+ * Log the throughput of each kernel and of its scalar version.
+ */
+static void run_kernel_benchmark() {
+    rgb565_benchmark_result_t results[RGB565_BENCHMARK_KERNEL_COUNT];
+    rgb565_benchmark_run(results);
+    for (size_t i = 0; i < ARRAY_SIZE(results); i++) {
+        LOG_INF("%s kernel: %u MB/s, scalar %u MB/s.", results[i].name, results[i].throughput,
+                results[i].throughput_scalar);
+    }
+}
+
+/* RUN_TRANSITION_BENCHMARK
+ * Slide to the menu and back through the navigation, with live rendering and then with snapshots.
+ * The transitions log their frame rates.
+ */
+static void run_transition_benchmark() {
+    static const bool snapshots[] = { false, true };
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(snapshots); i++) {
+        screen_transition_set_snapshots(snapshots[i]);
+        navigation_push(SCREEN_MENU, LV_SCR_LOAD_ANIM_MOVE_TOP);
+        wait_for_transition();
+        navigation_pop();
+        wait_for_transition();
+    }
+}
+
+/* WAIT_FOR_TRANSITION
+ * Run LVGL's timers until the transition is finished.
+ */
+static void wait_for_transition() {
+    while (screen_transition_is_running()) {
+        k_msleep(MIN(lv_timer_handler(), LV_DEF_REFR_PERIOD));
+    }
+}
+
+/* FRAME_TIME_CALLBACK
+ * Measure the time from the start of each refresh until its last band is sent.
+ */
+static void frame_time_callback(lv_event_t *event) {
+    if (lv_event_get_code(event) == LV_EVENT_REFR_START) {
+        frame_start_cycles = k_cycle_get_32();
+        return;
+    }
+
+    uint32_t frame_time_us = k_cyc_to_us_floor32(k_cycle_get_32() - frame_start_cycles);
+    frame_time_min_us = MIN(frame_time_min_us, frame_time_us);
+    frame_time_max_us = MAX(frame_time_max_us, frame_time_us);
+    frame_time_total_us += frame_time_us;
+    frame_count++;
+}
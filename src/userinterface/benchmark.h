@@ -0,0 +1,27 @@
+/** Display benchmark for ZephyrWatch.
+ * Measures the display traffic of a full-screen refresh and of the home-to-menu screen load
+ * animation, the frame times of the animation, the redraw of the clock digits, the throughput of
+ * the RGB565 kernels, and the frame rates of the live and the snapshot slides. It is run at boot
+ * with the ZEPHYRWATCH_DISPLAY_BENCHMARK CMake option.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_BENCHMARK_H
+#define _SMART_WATCH_UI_BENCHMARK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Run the benchmark and log its results. It must be called by the LVGL-owner thread, after the
+ * user interface is initialized. The home screen is shown again at the end.
+ */
+void run_display_benchmark();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+/** Energy model of the user interface for ZephyrWatch.
+ * The time and the CPU time of an interval are accounted to the mode when the mode is switched, or
+ * when the counters are read. The CPU time is taken from the thread runtime statistics, as the
+ * cycles not spent by the idle thread.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "userinterface/energymodel.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_EnergyModel, LOG_LEVEL_INF);
+
+#define MSEC_PER_HOUR (3600 * MSEC_PER_SEC)
+
+static const char *mode_names[ENERGY_MODE_COUNT] = { "Normal", "Ambient", "Sleep" };
+
+static struct k_spinlock energy_lock;
+static energy_counters_t counters[ENERGY_MODE_COUNT];
+static energy_mode_t current_mode = ENERGY_MODE_NORMAL;
+static int64_t interval_start_ms = 0;
+static uint64_t interval_start_awake_cycles = 0;
+
+/* Prototype definition of internal static functions. */
+static void account_interval();
+static uint64_t get_awake_cycles();
+static int compute_rates(const energy_counters_t *mode_counters, energy_rates_t *rates);
+static uint64_t per_hour(uint64_t value, uint64_t residency_ms);
+
+/* ENERGY_MODEL_SET_MODE
+ * Account the interval to the current mode, and start an interval of the new mode.
+ */
+void energy_model_set_mode(energy_mode_t mode) {
+    K_SPINLOCK(&energy_lock) {
+        account_interval();
+        current_mode = mode;
+    }
+}
+
+/* ENERGY_MODEL_COUNT_FRAME
+ * Count a frame of the current mode.
+ */
+void energy_model_count_frame(uint32_t pixels) {
+    K_SPINLOCK(&energy_lock) {
+        counters[current_mode].frame_count++;
+        counters[current_mode].flushed_pixels += pixels;
+    }
+}
+
+/* ENERGY_MODEL_GET_COUNTERS
+ * Account the current interval, and copy the counters of the mode.
+ */
+void energy_model_get_counters(energy_mode_t mode, energy_counters_t *copy) {
+    K_SPINLOCK(&energy_lock) {
+        account_interval();
+        *copy = counters[mode];
+    }
+}
+
+/* ENERGY_MODEL_GET_RATES
+ * Account the current interval, and normalize the counters of the mode to an hour in the mode.
+ */
+int energy_model_get_rates(energy_mode_t mode, energy_rates_t *rates) {
+    energy_counters_t mode_counters;
+    energy_model_get_counters(mode, &mode_counters);
+    return compute_rates(&mode_counters, rates);
+}
+
+/* ENERGY_MODEL_LOG
+ * Log the counters of each mode which has been used, normalized to an hour in the mode.
+ */
+void energy_model_log() {
+    for (energy_mode_t mode = 0; mode < ENERGY_MODE_COUNT; mode++) {
+        energy_counters_t mode_counters;
+        energy_rates_t rates;
+        energy_model_get_counters(mode, &mode_counters);
+        if (compute_rates(&mode_counters, &rates) != 0) {
+            continue;
+        }
+
+        LOG_INF("%s mode: %u s, per hour %llu frames, %llu pixels, %llu ms CPU awake.",
+                mode_names[mode], (uint32_t)(mode_counters.residency_ms / MSEC_PER_SEC),
+                (unsigned long long)rates.frame_count, (unsigned long long)rates.flushed_pixels,
+                (unsigned long long)rates.cpu_awake_ms);
+    }
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* ACCOUNT_INTERVAL
+ * Add the time and the CPU time since the start of the interval to the current mode, and start a
+ * new interval. It is called with the lock held.
+ */
+static void account_interval() {
+    int64_t now_ms = k_uptime_get();
+    uint64_t awake_cycles = get_awake_cycles();
+
+    counters[current_mode].residency_ms += now_ms - interval_start_ms;
+    counters[current_mode].cpu_awake_ms += k_cyc_to_ms_floor64(awake_cycles - interval_start_awake_cycles);
+    interval_start_ms = now_ms;
+    interval_start_awake_cycles = awake_cycles;
+}
+
+/* GET_AWAKE_CYCLES
+ * Return the cycles spent by the threads other than the idle thread since boot.
+ */
+static uint64_t get_awake_cycles() {
+    k_thread_runtime_stats_t stats;
+    if (k_thread_runtime_stats_all_get(&stats) != 0) {
+        return interval_start_awake_cycles;
+    }
+    return stats.execution_cycles - stats.idle_cycles;
+}
+
+/* COMPUTE_RATES
+ * Normalize the counters to an hour in the mode. A mode which has not been used has no rates.
+ */
+static int compute_rates(const energy_counters_t *mode_counters, energy_rates_t *rates) {
+    if (mode_counters->residency_ms == 0) {
+        return -ENODATA;
+    }
+
+    rates->frame_count = per_hour(mode_counters->frame_count, mode_counters->residency_ms);
+    rates->flushed_pixels = per_hour(mode_counters->flushed_pixels, mode_counters->residency_ms);
+    rates->cpu_awake_ms = per_hour(mode_counters->cpu_awake_ms, mode_counters->residency_ms);
+    return 0;
+}
+
+/* PER_HOUR
+ * Scale the value counted in the residency to an hour. The flushed pixels of an hour do not fit in
+ * 32 bits beyond about 20 full frames per second.
+ */
+static uint64_t per_hour(uint64_t value, uint64_t residency_ms) {
+    return value * MSEC_PER_HOUR / residency_ms;
+}
@@ -0,0 +1,65 @@
+/** Energy model of the user interface for ZephyrWatch.
+ * Counts the frames, the flushed pixels, and the CPU time spent awake in each display mode, so the
+ * cost of the modes can be compared per hour of use.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_ENERGYMODEL_H
+#define _SMART_WATCH_UI_ENERGYMODEL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The display modes which are accounted separately. */
+typedef enum {
+    ENERGY_MODE_NORMAL,   // Full user interface at the user's brightness.
+    ENERGY_MODE_AMBIENT,  // Minimal watch face at the minimum brightness.
+    ENERGY_MODE_SLEEP,    // Blanked panel.
+    ENERGY_MODE_COUNT,
+} energy_mode_t;
+
+/* The counters of a mode since boot. */
+typedef struct {
+    uint64_t residency_ms;    // Time spent in the mode.
+    uint64_t cpu_awake_ms;    // CPU time of all threads except the idle thread.
+    uint32_t frame_count;     // Refreshes which flushed pixels.
+    uint64_t flushed_pixels;  // Pixels flushed by LVGL.
+} energy_counters_t;
+
+/* The counters of a mode normalized to an hour in the mode. */
+typedef struct {
+    uint64_t frame_count;
+    uint64_t flushed_pixels;
+    uint64_t cpu_awake_ms;
+} energy_rates_t;
+
+/* Switch the mode the following activity is accounted to. */
+void energy_model_set_mode(energy_mode_t mode);
+
+/* Count a frame and its flushed pixels for the current mode. */
+void energy_model_count_frame(uint32_t pixels);
+
+/* Copy the counters of the mode, including the current interval if it is the current mode. */
+void energy_model_get_counters(energy_mode_t mode, energy_counters_t *counters);
+
+/**
+ * Get the counters of the mode per hour in the mode, including the current interval.
+ * @param mode The mode to get.
+ * @param rates The counters per hour.
+ * @return 0 on success, -ENODATA if the mode has not been used yet.
+ */
+int energy_model_get_rates(energy_mode_t mode, energy_rates_t *rates);
+
+/* Log the frames, the flushed pixels and the CPU-awake milliseconds per hour of each mode. */
+void energy_model_log();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+/** Navigation for ZephyrWatch.
+ * Each stack entry keeps the animation which showed its screen, to play its reverse when going back.
+ * The screens are shown by the screen transitions through the screen manager, so a screen under the
+ * top may be evicted and built again when it is shown. The gesture handler is added to each screen
+ * when the screen manager creates it.
+ *
+ * The time from a navigation to the end of the first frame which flushed pixels after it is logged
+ * for each transition, with whether the screen had to be built first.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "userinterface/navigation.h"
+#include "userinterface/screentransition.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_UI_Navigation, LOG_LEVEL_INF);
+
+// The deepest navigation, and the number of the gesture bindings.
+#define NAVIGATION_MAX_DEPTH 8
+#define NAVIGATION_MAX_BINDINGS 8
+
+// The duration of the screen load animations.
+#define NAVIGATION_ANIMATION_MS 300
+
+typedef struct {
+    screen_id_t id;
+    lv_screen_load_anim_t animation;
+} navigation_entry_t;
+
+typedef struct {
+    screen_id_t id;
+    lv_dir_t direction;
+    screen_id_t target;
+    lv_screen_load_anim_t animation;
+} gesture_binding_t;
+
+typedef struct {
+    bool pending;
+    bool flushed;
+    bool built;  // The screen did not exist when the transition started.
+    screen_id_t from;
+    screen_id_t to;
+    uint32_t start_cycles;
+} transition_t;
+
+static navigation_entry_t stack[NAVIGATION_MAX_DEPTH];
+static uint32_t stack_depth = 0;
+static gesture_binding_t bindings[NAVIGATION_MAX_BINDINGS];
+static uint32_t binding_count = 0;
+static transition_t transition;
+
+/* Prototype definition of internal static functions. */
+static void show_screen(screen_id_t id, lv_screen_load_anim_t animation);
+static lv_screen_load_anim_t reverse_animation(lv_screen_load_anim_t animation);
+static void screen_created_callback(screen_id_t id, lv_obj_t *screen);
+static void gesture_event_callback(lv_event_t *event);
+static void display_event_callback(lv_event_t *event);
+
+/* NAVIGATION_INIT
+ * Add the gesture handlers to the created screens, start measuring the transitions, and show the
+ * root screen.
+ */
+void navigation_init(screen_id_t root) {
+    screen_manager_set_created_callback(screen_created_callback);
+
+    lv_display_t *display = lv_display_get_default();
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_REFR_READY, NULL);
+
+    navigation_reset(root);
+}
+
+/* NAVIGATION_RESET
+ * Clear the stack, and show the root screen.
+ */
+void navigation_reset(screen_id_t root) {
+    stack[0].id = root;
+    stack[0].animation = LV_SCR_LOAD_ANIM_NONE;
+    stack_depth = 1;
+    show_screen(root, LV_SCR_LOAD_ANIM_NONE);
+}
+
+/* NAVIGATION_PUSH
+ * Show the screen over the shown one, or go back to it if it is in the stack.
+ */
+int navigation_push(screen_id_t id, lv_screen_load_anim_t animation) {
+    if (id >= SCREEN_COUNT) {
+        return -EINVAL;
+    }
+
+    for (uint32_t i = 0; i < stack_depth; i++) {
+        if (stack[i].id != id) {
+            continue;
+        }
+        if (i + 1 < stack_depth) {
+            lv_screen_load_anim_t back_animation = reverse_animation(stack[i + 1].animation);
+            stack_depth = i + 1;
+            show_screen(id, back_animation);
+        }
+        return 0;
+    }
+
+    if (stack_depth == NAVIGATION_MAX_DEPTH) {
+        LOG_WRN("Navigation stack is full, %s screen is not shown.", screen_manager_get_name(id));
+        return -ENOMEM;
+    }
+    stack[stack_depth].id = id;
+    stack[stack_depth].animation = animation;
+    stack_depth++;
+    show_screen(id, animation);
+    return 0;
+}
+
+/* NAVIGATION_POP
+ * Go back to the screen under the shown one with the reverse animation.
+ */
+int navigation_pop() {
+    if (stack_depth <= 1) {
+        return -ENOENT;
+    }
+
+    stack_depth--;
+    show_screen(stack[stack_depth - 1].id, reverse_animation(stack[stack_depth].animation));
+    return 0;
+}
+
+/* NAVIGATION_REPLACE
+ * Show the screen in place of the shown one.
+ */
+int navigation_replace(screen_id_t id, lv_screen_load_anim_t animation) {
+    if (id >= SCREEN_COUNT) {
+        return -EINVAL;
+    }
+    if (stack[stack_depth - 1].id == id) {
+        return 0;
+    }
+
+    stack[stack_depth - 1].id = id;
+    stack[stack_depth - 1].animation = animation;
+    show_screen(id, animation);
+    return 0;
+}
+
+/* NAVIGATION_CLOSE
+ * Remove the screen from the stack, going back if it is shown.
+ */
+int navigation_close(screen_id_t id) {
+    for (uint32_t i = 1; i < stack_depth; i++) {
+        if (stack[i].id != id) {
+            continue;
+        }
+        if (i == stack_depth - 1) {
+            return navigation_pop();
+        }
+        // The screen over it is shown with its own animation, so its reverse is still the way back.
+        for (uint32_t j = i; j + 1 < stack_depth; j++) {
+            stack[j] = stack[j + 1];
+        }
+        stack_depth--;
+        return 0;
+    }
+    return -ENOENT;
+}
+
+/* NAVIGATION_GET_TOP
+ * Return the shown screen of the stack.
+ */
+screen_id_t navigation_get_top() {
+    return stack_depth > 0 ? stack[stack_depth - 1].id : SCREEN_NONE;
+}
+
+/* NAVIGATION_BIND_GESTURE
+ * Add a gesture binding. The screens created later get the gesture handler.
+ */
+int navigation_bind_gesture(screen_id_t id, lv_dir_t direction, screen_id_t target,
+                            lv_screen_load_anim_t animation) {
+    if (id >= SCREEN_COUNT || target > SCREEN_NONE) {
+        return -EINVAL;
+    }
+    if (binding_count == NAVIGATION_MAX_BINDINGS) {
+        return -ENOMEM;
+    }
+
+    bindings[binding_count].id = id;
+    bindings[binding_count].direction = direction;
+    bindings[binding_count].target = target;
+    bindings[binding_count].animation = animation;
+    binding_count++;
+    return 0;
+}
+
+/* NAVIGATION_PRELOAD_NEIGHBORS
+ * Build the screen under the shown one and the gesture targets of the shown one, so the next
+ * transition does not build a screen before its first frame.
+ */
+void navigation_preload_neighbors() {
+    screen_id_t top = navigation_get_top();
+    if (stack_depth > 1) {
+        screen_manager_preload(stack[stack_depth - 2].id);
+    }
+    for (uint32_t i = 0; i < binding_count; i++) {
+        if (bindings[i].id == top && bindings[i].target != SCREEN_NONE) {
+            screen_manager_preload(bindings[i].target);
+        }
+    }
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* SHOW_SCREEN
+ * Show the screen, and start measuring the transition to it.
+ */
+static void show_screen(screen_id_t id, lv_screen_load_anim_t animation) {
+    transition.pending = true;
+    transition.flushed = false;
+    transition.built = !screen_manager_is_created(id);
+    transition.from = screen_manager_get_active();
+    transition.to = id;
+    transition.start_cycles = k_cycle_get_32();
+
+    uint32_t time_ms = animation == LV_SCR_LOAD_ANIM_NONE ? 0 : NAVIGATION_ANIMATION_MS;
+    screen_transition_start(id, animation, time_ms);
+}
+
+/* REVERSE_ANIMATION
+ * Return the animation which undoes the given one.
+ */
+static lv_screen_load_anim_t reverse_animation(lv_screen_load_anim_t animation) {
+    switch (animation) {
+    case LV_SCR_LOAD_ANIM_OVER_LEFT:
+        return LV_SCR_LOAD_ANIM_OUT_RIGHT;
+    case LV_SCR_LOAD_ANIM_OVER_RIGHT:
+        return LV_SCR_LOAD_ANIM_OUT_LEFT;
+    case LV_SCR_LOAD_ANIM_OVER_TOP:
+        return LV_SCR_LOAD_ANIM_OUT_BOTTOM;
+    case LV_SCR_LOAD_ANIM_OVER_BOTTOM:
+        return LV_SCR_LOAD_ANIM_OUT_TOP;
+    case LV_SCR_LOAD_ANIM_MOVE_LEFT:
+        return LV_SCR_LOAD_ANIM_MOVE_RIGHT;
+    case LV_SCR_LOAD_ANIM_MOVE_RIGHT:
+        return LV_SCR_LOAD_ANIM_MOVE_LEFT;
+    case LV_SCR_LOAD_ANIM_MOVE_TOP:
+        return LV_SCR_LOAD_ANIM_MOVE_BOTTOM;
+    case LV_SCR_LOAD_ANIM_MOVE_BOTTOM:
+        return LV_SCR_LOAD_ANIM_MOVE_TOP;
+    case LV_SCR_LOAD_ANIM_FADE_IN:
+        return LV_SCR_LOAD_ANIM_FADE_OUT;
+    case LV_SCR_LOAD_ANIM_FADE_OUT:
+        return LV_SCR_LOAD_ANIM_FADE_IN;
+    default:
+        return LV_SCR_LOAD_ANIM_NONE;
+    }
+}
+
+/* SCREEN_CREATED_CALLBACK
+ * Add the gesture handler to the screen if any gesture is bound on it.
+ */
+static void screen_created_callback(screen_id_t id, lv_obj_t *screen) {
+    for (uint32_t i = 0; i < binding_count; i++) {
+        if (bindings[i].id == id) {
+            lv_obj_add_event_cb(screen, gesture_event_callback, LV_EVENT_GESTURE, (void *)(uintptr_t)id);
+            return;
+        }
+    }
+}
+
+/* GESTURE_EVENT_CALLBACK
+ * Run the navigation bound to the gesture, if the screen is the shown one.
+ */
+static void gesture_event_callback(lv_event_t *event) {
+    screen_id_t id = (screen_id_t)(uintptr_t)lv_event_get_user_data(event);
+    if (id != navigation_get_top()) {
+        return;
+    }
+
+    lv_dir_t direction = lv_indev_get_gesture_dir(lv_indev_active());
+    for (uint32_t i = 0; i < binding_count; i++) {
+        if (bindings[i].id != id || bindings[i].direction != direction) {
+            continue;
+        }
+        if (bindings[i].target == SCREEN_NONE) {
+            navigation_pop();
+        } else {
+            navigation_push(bindings[i].target, bindings[i].animation);
+        }
+        return;
+    }
+}
+
+/* DISPLAY_EVENT_CALLBACK
+ * Log the time to the end of the first frame which flushed pixels after a navigation.
+ */
+static void display_event_callback(lv_event_t *event) {
+    if (!transition.pending) {
+        return;
+    }
+    if (lv_event_get_code(event) == LV_EVENT_FLUSH_START) {
+        transition.flushed = true;
+        return;
+    }
+    if (!transition.flushed) {
+        return;
+    }
+
+    transition.pending = false;
+    LOG_INF("%s to %s: first frame in %u us%s.", screen_manager_get_name(transition.from),
+            screen_manager_get_name(transition.to),
+            k_cyc_to_us_floor32(k_cycle_get_32() - transition.start_cycles),
+            transition.built ? ", the screen was built" : "");
+}
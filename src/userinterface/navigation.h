@@ -0,0 +1,83 @@
+/** Navigation for ZephyrWatch.
+ * Keeps the screens the user navigated through in a stack, with the shown screen at its top. Going
+ * back plays the reverse of the animation which showed the screen. Gestures on a screen are bound to
+ * push a screen or to go back, and the screens reachable from the shown one are built while the UI
+ * is idle. All functions are only called by the LVGL-owner thread.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_NAVIGATION_H
+#define _SMART_WATCH_UI_NAVIGATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+#include "userinterface/screenmanager.h"
+
+/* Set up the navigation, and show the root screen without an animation. The screen manager must be
+ * initialized before.
+ */
+void navigation_init(screen_id_t root);
+
+/* Clear the stack, and show the root screen without an animation. */
+void navigation_reset(screen_id_t root);
+
+/**
+ * Show a screen over the shown one. If the screen is already in the stack, the screens over it are
+ * removed instead of stacking it twice.
+ * @param id The screen to show.
+ * @param animation The animation to show it with. Going back plays its reverse.
+ * @return 0 on success, -ENOMEM if the stack is full, -EINVAL if the screen is unknown.
+ */
+int navigation_push(screen_id_t id, lv_screen_load_anim_t animation);
+
+/**
+ * Go back to the screen under the shown one.
+ * @return 0 on success, -ENOENT if the shown screen is the root.
+ */
+int navigation_pop();
+
+/**
+ * Show a screen in place of the shown one, so going back skips the shown one.
+ * @param id The screen to show.
+ * @param animation The animation to show it with.
+ * @return 0 on success, -EINVAL if the screen is unknown.
+ */
+int navigation_replace(screen_id_t id, lv_screen_load_anim_t animation);
+
+/**
+ * Remove a screen from the stack, e.g. an overlay which is not needed anymore. If it is shown, it is
+ * the same as going back.
+ * @param id The screen to remove.
+ * @return 0 on success, -ENOENT if the screen is not in the stack or is the root.
+ */
+int navigation_close(screen_id_t id);
+
+/* Return the shown screen of the stack. */
+screen_id_t navigation_get_top();
+
+/**
+ * Bind a gesture on a screen to a navigation.
+ * @param id The screen which receives the gesture.
+ * @param direction The direction of the gesture.
+ * @param target The screen to push, or SCREEN_NONE to go back.
+ * @param animation The animation to push the target with. It is not used when going back.
+ * @return 0 on success, -ENOMEM if there are too many bindings, -EINVAL if the screen is unknown.
+ */
+int navigation_bind_gesture(screen_id_t id, lv_dir_t direction, screen_id_t target,
+                            lv_screen_load_anim_t animation);
+
+/* Build the screens the shown one can navigate to which do not exist, while they fit in the screen
+ * manager's budget. It is called when the UI becomes idle.
+ */
+void navigation_preload_neighbors();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,285 @@
+/** Screen Manager for ZephyrWatch.
+ * Each screen module keeps its screen object in a global, and the manager creates it with the
+ * module's init function. The LVGL heap used by the init function is the screen's cost. The global
+ * is cleared when the screen is deleted, whoever deletes it, so it never dangles.
+ *
+ * When a screen is hidden, the least recently shown screens which are neither shown nor pinned are
+ * deleted until the costs fit in the budget. The eviction runs after the hiding screen load is
+ * finished, since LVGL still uses the hidden screen while it sends the unload event.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <errno.h>
+#include <zephyr/logging/log.h>
+
+#include "userinterface/screenmanager.h"
+#include "userinterface/utils.h"
+#include "userinterface/screens/home/home.h"
+#include "userinterface/screens/menu/menu.h"
+#include "userinterface/screens/blepairing/blepairing.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_UI_ScreenManager, LOG_LEVEL_INF);
+
+typedef struct {
+    const char *name;
+    void (*create)();
+    lv_obj_t **object;
+    bool pinned;               // Never evicted, e.g. the watch face.
+    uint32_t cost_bytes;       // The LVGL heap used by the init function.
+    uint32_t last_cost_bytes;  // The cost when it was last created, kept after it is deleted.
+    uint32_t shown_tick;       // The show counter when it was last shown.
+} screen_entry_t;
+
+static screen_entry_t screens[SCREEN_COUNT] = {
+    [SCREEN_HOME] = { .name = "Home", .create = home_screen_init, .object = &home_screen, .pinned = true },
+    [SCREEN_MENU] = { .name = "Menu", .create = menu_screen_init, .object = &menu_screen },
+    [SCREEN_BLEPAIRING] = { .name = "BLE pairing", .create = blepairing_screen_init,
+                            .object = &blepairing_screen },
+};
+
+static uint32_t budget_bytes = UINT32_MAX;
+static uint32_t show_tick = 0;
+static uint32_t eviction_count = 0;
+static bool eviction_pending = false;
+static screen_created_callback_t created_callback = NULL;
+
+/* Prototype definition of internal static functions. */
+static void create_screen_entry(screen_entry_t *entry);
+static void screen_event_callback(lv_event_t *event);
+static void schedule_eviction();
+static void evict_over_budget(void *user_data);
+static uint32_t get_used_bytes();
+
+/* SCREEN_MANAGER_INIT
+ * Set the budget of the screens.
+ */
+void screen_manager_init(uint32_t budget) {
+    budget_bytes = budget;
+    LOG_DBG("Screen manager budget is %u bytes.", budget);
+}
+
+/* SCREEN_MANAGER_SET_CREATED_CALLBACK
+ * Set the function called after each screen is created.
+ */
+void screen_manager_set_created_callback(screen_created_callback_t callback) {
+    created_callback = callback;
+}
+
+/* SCREEN_MANAGER_GET
+ * Return the screen, and create it first if it does not exist.
+ */
+lv_obj_t* screen_manager_get(screen_id_t id) {
+    if (id >= SCREEN_COUNT) {
+        return NULL;
+    }
+
+    screen_entry_t *entry = &screens[id];
+    if (*entry->object == NULL) {
+        create_screen_entry(entry);
+    }
+    return *entry->object;
+}
+
+/* SCREEN_MANAGER_PRELOAD
+ * Create the screen if it does not exist, and it fits in the budget by its last cost. A screen which
+ * was never created is tried once; if it does not fit, the eviction handles it as any other.
+ */
+int screen_manager_preload(screen_id_t id) {
+    if (id >= SCREEN_COUNT) {
+        return -EINVAL;
+    }
+
+    screen_entry_t *entry = &screens[id];
+    if (*entry->object != NULL) {
+        return 0;
+    }
+    if (get_used_bytes() + entry->last_cost_bytes > budget_bytes) {
+        return -ENOMEM;
+    }
+
+    entry->shown_tick = ++show_tick;
+    create_screen_entry(entry);
+    LOG_DBG("%s screen is preloaded.", entry->name);
+    return 0;
+}
+
+/* SCREEN_MANAGER_IS_CREATED
+ * Return whether the screen exists.
+ */
+bool screen_manager_is_created(screen_id_t id) {
+    return id < SCREEN_COUNT && *screens[id].object != NULL;
+}
+
+/* SCREEN_MANAGER_SHOW
+ * Load the screen with the animation. The screen which is hidden is not deleted by LVGL.
+ */
+int screen_manager_show(screen_id_t id, lv_screen_load_anim_t animation, uint32_t time_ms) {
+    lv_obj_t *screen = screen_manager_get(id);
+    if (screen == NULL) {
+        return -EINVAL;
+    }
+
+    screens[id].shown_tick = ++show_tick;
+    if (screen != lv_screen_active()) {
+        lv_screen_load_anim(screen, animation, time_ms, 0, false);
+    }
+    return 0;
+}
+
+/* SCREEN_MANAGER_DESTROY
+ * Delete the screen if it is hidden.
+ */
+int screen_manager_destroy(screen_id_t id) {
+    if (id >= SCREEN_COUNT) {
+        return -EINVAL;
+    }
+
+    lv_obj_t *screen = *screens[id].object;
+    if (screen == NULL) {
+        return 0;
+    }
+    if (screen == lv_screen_active()) {
+        return -EBUSY;
+    }
+    // The delete event clears the module's global and the cost.
+    lv_obj_delete(screen);
+    return 0;
+}
+
+/* SCREEN_MANAGER_GET_ACTIVE
+ * Return the id of the screen which is shown.
+ */
+screen_id_t screen_manager_get_active() {
+    lv_obj_t *active = lv_screen_active();
+    for (screen_id_t id = 0; id < SCREEN_COUNT; id++) {
+        if (active != NULL && *screens[id].object == active) {
+            return id;
+        }
+    }
+    return SCREEN_NONE;
+}
+
+/* SCREEN_MANAGER_GET_COST
+ * Return the cost of the screen.
+ */
+uint32_t screen_manager_get_cost(screen_id_t id) {
+    return id < SCREEN_COUNT ? screens[id].cost_bytes : 0;
+}
+
+/* SCREEN_MANAGER_GET_NAME
+ * Return the name of the screen.
+ */
+const char* screen_manager_get_name(screen_id_t id) {
+    return id < SCREEN_COUNT ? screens[id].name : "None";
+}
+
+/* SCREEN_MANAGER_GET_STATS
+ * Return the costs of the existing screens, and the number of evictions.
+ */
+void screen_manager_get_stats(uint32_t *used_bytes, uint32_t *evictions) {
+    *used_bytes = get_used_bytes();
+    *evictions = eviction_count;
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* CREATE_SCREEN_ENTRY
+ * Create the screen with its module's init function, and measure its cost.
+ */
+static void create_screen_entry(screen_entry_t *entry) {
+    uint32_t heap_used_before = get_heap_used();
+    entry->create();
+    uint32_t heap_used_after = get_heap_used();
+
+    entry->cost_bytes = heap_used_after > heap_used_before ? heap_used_after - heap_used_before : 0;
+    entry->last_cost_bytes = entry->cost_bytes;
+    log_screen_heap_usage(entry->name, heap_used_before);
+    lv_obj_add_event_cb(*entry->object, screen_event_callback, LV_EVENT_DELETE, entry);
+    lv_obj_add_event_cb(*entry->object, screen_event_callback, LV_EVENT_SCREEN_UNLOADED, entry);
+    if (created_callback != NULL) {
+        created_callback(entry - screens, *entry->object);
+    }
+
+    if (get_used_bytes() > budget_bytes) {
+        schedule_eviction();
+    }
+}
+
+/* SCREEN_EVENT_CALLBACK
+ * Forget the deleted screens, and check the budget when a screen is hidden.
+ */
+static void screen_event_callback(lv_event_t *event) {
+    screen_entry_t *entry = lv_event_get_user_data(event);
+
+    if (lv_event_get_code(event) == LV_EVENT_DELETE) {
+        *entry->object = NULL;
+        entry->cost_bytes = 0;
+        LOG_DBG("%s screen is deleted.", entry->name);
+        return;
+    }
+    if (get_used_bytes() > budget_bytes) {
+        schedule_eviction();
+    }
+}
+
+/* SCHEDULE_EVICTION
+ * Run the eviction from LVGL's timer handler, after the current screen load is finished.
+ */
+static void schedule_eviction() {
+    if (eviction_pending) {
+        return;
+    }
+    if (lv_async_call(evict_over_budget, NULL) == LV_RESULT_OK) {
+        eviction_pending = true;
+    }
+}
+
+/* EVICT_OVER_BUDGET
+ * Delete the least recently shown hidden screens until the costs fit in the budget. While a screen
+ * load is animating, the screens may still be drawn, so it is tried again at the next timer run.
+ */
+static void evict_over_budget(void *user_data) {
+    eviction_pending = false;
+    if (lv_anim_count_running() > 0) {
+        schedule_eviction();
+        return;
+    }
+
+    lv_obj_t *active = lv_screen_active();
+    while (get_used_bytes() > budget_bytes) {
+        screen_entry_t *victim = NULL;
+        for (screen_id_t id = 0; id < SCREEN_COUNT; id++) {
+            screen_entry_t *entry = &screens[id];
+            if (*entry->object == NULL || *entry->object == active || entry->pinned) {
+                continue;
+            }
+            if (victim == NULL || entry->shown_tick < victim->shown_tick) {
+                victim = entry;
+            }
+        }
+        if (victim == NULL) {
+            LOG_WRN("Screens use %u bytes over the %u bytes budget, nothing to evict.", get_used_bytes(),
+                    budget_bytes);
+            return;
+        }
+
+        LOG_DBG("Evicting %s screen of %u bytes.", victim->name, victim->cost_bytes);
+        lv_obj_delete(*victim->object);
+        eviction_count++;
+    }
+}
+
+/* GET_USED_BYTES
+ * Sum the costs of the existing screens.
+ */
+static uint32_t get_used_bytes() {
+    uint32_t used_bytes = 0;
+    for (screen_id_t id = 0; id < SCREEN_COUNT; id++) {
+        used_bytes += screens[id].cost_bytes;
+    }
+    return used_bytes;
+}
@@ -0,0 +1,75 @@
+/** Screen Manager for ZephyrWatch.
+ * Owns the lifecycle of the screens: they are created when they are first shown, and the least
+ * recently used hidden ones are destroyed when the screens use more of the LVGL heap than the
+ * budget. All functions are only called by the LVGL-owner thread.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_SCREENMANAGER_H
+#define _SMART_WATCH_UI_SCREENMANAGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+/* The managed screens. */
+typedef enum {
+    SCREEN_HOME,
+    SCREEN_MENU,
+    SCREEN_BLEPAIRING,
+    SCREEN_COUNT,
+    SCREEN_NONE = SCREEN_COUNT,
+} screen_id_t;
+
+/* Called after a screen is created, e.g. to add event handlers to it. */
+typedef void (*screen_created_callback_t)(screen_id_t id, lv_obj_t *screen);
+
+/* Set the LVGL heap budget of the screens in bytes. */
+void screen_manager_init(uint32_t budget_bytes);
+
+/* Set the function called after each screen is created, or NULL. */
+void screen_manager_set_created_callback(screen_created_callback_t callback);
+
+/* Return the screen, creating it if it does not exist. Returns NULL if the screen is unknown. */
+lv_obj_t* screen_manager_get(screen_id_t id);
+
+/* Create the screen ahead of showing it, if its cost when it was last created fits in the budget
+ * with the existing screens. It counts as shown, so it is not the first to be evicted. Returns 0 if
+ * the screen exists or is created, -ENOMEM if it does not fit, -EINVAL if the screen is unknown.
+ */
+int screen_manager_preload(screen_id_t id);
+
+/* Return whether the screen exists. */
+bool screen_manager_is_created(screen_id_t id);
+
+/* Show the screen with the animation, creating it if it does not exist. The previous screen is kept
+ * hidden until it is evicted. Returns 0 on success, -EINVAL if the screen is unknown.
+ */
+int screen_manager_show(screen_id_t id, lv_screen_load_anim_t animation, uint32_t time_ms);
+
+/* Destroy the screen if it exists and is not shown. Returns 0 on success, -EBUSY if it is shown. */
+int screen_manager_destroy(screen_id_t id);
+
+/* Return the id of the shown screen, or SCREEN_NONE if it is not a managed one. */
+screen_id_t screen_manager_get_active();
+
+/* Return the LVGL heap bytes the screen used when it was created, or 0 if it does not exist. */
+uint32_t screen_manager_get_cost(screen_id_t id);
+
+/* Return the name of the screen for logging. */
+const char* screen_manager_get_name(screen_id_t id);
+
+/* Get the LVGL heap bytes used by the existing screens, and the number of the evicted screens. */
+void screen_manager_get_stats(uint32_t *used_bytes, uint32_t *eviction_count);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
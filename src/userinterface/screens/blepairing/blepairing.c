@@ -10,6 +10,8 @@
 #include <string.h>
 #include "lvgl.h"
 #include "userinterface/utils.h"
+#include "userinterface/navigation.h"
+#include "userinterface/styles/widgetstyle.h"
 #include "userinterface/screens/blepairing/blepairing.h"
 
 // Create a logger.
@@ -23,7 +25,6 @@ static void render_footer_label(lv_obj_t *flex_element);
 
 // Holds the BLE pairing screen objects.
 lv_obj_t *blepairing_screen;
-lv_obj_t *previous_screen;
 static lv_obj_t *label_title;
 static lv_obj_t *label_instruction;
 static lv_obj_t *pin_container;
@@ -81,8 +82,7 @@ static void render_title_label(lv_obj_t *flex_element) {
     lv_obj_set_align(label_title, LV_ALIGN_CENTER);
 
     // Style the title
-    lv_obj_set_style_text_color(label_title, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label_title, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_add_style(label_title, get_widget_style_title(), LV_PART_MAIN);
     lv_obj_center(label_title);
 }
 
@@ -96,9 +96,7 @@ static void render_instruction_label(lv_obj_t *flex_element) {
     lv_obj_set_align(label_instruction, LV_ALIGN_CENTER);
 
     // Style the instruction
-    lv_obj_set_style_text_align(label_instruction, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(label_instruction, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(label_instruction, lv_color_white(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_style(label_instruction, get_widget_style_text(), LV_PART_MAIN);
 }
 
 static void render_pin_display(lv_obj_t *flex_element) {
@@ -107,17 +105,10 @@ static void render_pin_display(lv_obj_t *flex_element) {
     lv_obj_set_size(pin_container, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_obj_set_align(pin_container, LV_ALIGN_CENTER);
 
-    // Configure flexbox layout for PIN container
-    lv_obj_set_layout(pin_container, LV_LAYOUT_FLEX);
-    lv_obj_set_flex_flow(pin_container, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(pin_container, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_pad_column(pin_container, 8, LV_PART_MAIN);
-    lv_obj_set_style_pad_all(pin_container, 15, LV_PART_MAIN);
-
-    // Remove background and border from container
-    lv_obj_set_style_bg_opa(pin_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_opa(pin_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    
+    // Configure the flexbox layout without background and border for PIN container
+    lv_obj_add_style(pin_container, get_widget_style_digit_row(), LV_PART_MAIN);
+
+
     // Create individual digit displays
     for (int i = 0; i < 6; i++) {
         // Create a container for each digit
@@ -125,12 +116,7 @@ static void render_pin_display(lv_obj_t *flex_element) {
         lv_obj_set_size(digit_box, 25, 45);
 
         // Style the digit box with rounded corners and shadow
-        lv_obj_set_style_radius(digit_box, 8, LV_PART_MAIN);
-        lv_obj_set_style_bg_color(digit_box, lv_color_hex(0x404040), LV_PART_MAIN);
-        lv_obj_set_style_bg_opa(digit_box, LV_OPA_100, LV_PART_MAIN);
-        lv_obj_set_style_border_color(digit_box, lv_color_hex(0x555555), LV_PART_MAIN);
-        lv_obj_set_style_border_width(digit_box, 2, LV_PART_MAIN);
-        lv_obj_set_style_border_opa(digit_box, LV_OPA_50, LV_PART_MAIN);
+        lv_obj_add_style(digit_box, get_widget_style_digit_box(), LV_PART_MAIN);
 
         // Create the digit label
         pin_digits[i] = lv_label_create(digit_box);
@@ -140,9 +126,7 @@ static void render_pin_display(lv_obj_t *flex_element) {
         lv_obj_set_align(pin_digits[i], LV_ALIGN_CENTER);
 
         // Style the digit text
-        lv_obj_set_style_text_font(pin_digits[i], &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_text_color(pin_digits[i], lv_color_white(), LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_text_align(pin_digits[i], LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_add_style(pin_digits[i], get_widget_style_text(), LV_PART_MAIN);
     }
 }
 
@@ -156,9 +140,7 @@ static void render_footer_label(lv_obj_t *flex_element) {
     lv_obj_set_align(label_footer, LV_ALIGN_CENTER);
 
     // Style the footer
-    lv_obj_set_style_text_align(label_footer, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(label_footer, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(label_footer, lv_color_white(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_style(label_footer, get_widget_style_text(), LV_PART_MAIN);
 }
 
 uint8_t blepairing_screen_set_pin(const char *pin_code) {
@@ -182,23 +164,17 @@ uint8_t blepairing_screen_set_pin(const char *pin_code) {
     for (int i = 0; i < 6; i++) {
         lv_label_set_text_fmt(pin_digits[i], "%c", current_pin[i]);
     }
-    // Update the display
-    lv_disp_flush_ready(lv_disp_get_default());
     LOG_DBG("PIN code updated to: %s", current_pin);
     return 0;
 }
 
 void blepairing_screen_load() {
-    // Save the previous screen to unload afterwards.
-    previous_screen = lv_scr_act();
-    if (!lv_obj_is_valid(blepairing_screen)) {
-        blepairing_screen_init();
-    }
-    // Load the BLE pairing screen with animation.
-    lv_screen_load_anim(blepairing_screen, LV_SCR_LOAD_ANIM_FADE_IN, 300, 0, false);
+    // Show the BLE pairing screen over the shown one with animation. It is not stacked twice.
+    navigation_push(SCREEN_BLEPAIRING, LV_SCR_LOAD_ANIM_FADE_IN);
 }
 
 void blepairing_screen_unload() {
-    // Load the previous screen.
-    lv_screen_load_anim(previous_screen, LV_SCR_LOAD_ANIM_FADE_OUT, 300, 0, true);
+    // Return to the screen under it, or only remove it if another one is shown over it. The pairing
+    // screen is kept until the screen manager evicts it.
+    navigation_close(SCREEN_BLEPAIRING);
 }
\ No newline at end of file
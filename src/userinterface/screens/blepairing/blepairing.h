@@ -18,15 +18,15 @@ extern "C" {
 /* The screen object to be used in the userinterface. */
 extern lv_obj_t *blepairing_screen;
 
-/* The init implementation for the BLE Pairing screen. */
+/* The init implementation for the BLE Pairing screen. It is called by the screen manager. */
 void blepairing_screen_init();
 
-/** Load the BLE pairing screen.
+/** Load the BLE pairing screen, creating it if it does not exist.
  * @return void
  */
 void blepairing_screen_load();
 
-/** Unload the BLE pairing screen. 
+/** Unload the BLE pairing screen, returning to the screen shown before it. 
  * @return void
  */
 void blepairing_screen_unload();
@@ -37,7 +37,7 @@ void blepairing_screen_unload();
  */
 void blepairing_screen_event(lv_event_t * event);
 
-/** Set the PIN code to be displayed on the BLE pairing screen.
+/** Set the PIN code to be displayed on the BLE pairing screen. The screen must exist.
  * @param pin_code A 6-character string representing the PIN code.
  * @return 0 on success, 1 on failure.
  */
@@ -9,7 +9,8 @@
 #include "lvgl.h"
 #include "userinterface/userinterface.h"
 #include "userinterface/utils.h"
-#include "userinterface/screens/menu/menu.h"
+#include "userinterface/styles/widgetstyle.h"
+#include "userinterface/widgets/digitclock/digitclock.h"
 
 /* Names of the Weekdays */
 static const char* weekdays[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT" };
@@ -20,16 +21,28 @@ lv_obj_t *label_clock;
 lv_obj_t *label_date;
 lv_obj_t *label_day;
 
+// The row which is hidden in the ambient mode, leaving only the clock.
+static lv_obj_t *date_day_row;
+
+// Statistics of the clock label updates, and the last shown time to detect redundant updates.
+static uint32_t clock_update_count = 0;
+static uint32_t clock_redundant_update_count = 0;
+static uint32_t clock_changed_cell_count = 0;
+static int16_t shown_clock_minutes = -1;
+
 void home_screen_init() {
     // Create the screen object which is the LV object with no parent.
     home_screen = create_screen();
 
+    // The clock digits are pre-rendered on black, so the screen is black too.
+    lv_obj_set_style_bg_color(home_screen, lv_color_black(), LV_PART_MAIN);
+
     // Create a vertical flex layout container centered in the screen.
     lv_obj_t *main_column = create_column(home_screen, 100, 100);
 
     // Create a horizontal flex layout containers that will hold date and time labels.
     lv_obj_t *clock_label_row = create_row(main_column, 100, 20);
-    lv_obj_t *date_day_row = create_row(main_column, 100, 20);
+    date_day_row = create_row(main_column, 100, 20);
 
     // Add spacing between rows.
     lv_obj_set_style_pad_row(main_column, 5, LV_PART_MAIN);
@@ -39,71 +52,62 @@ void home_screen_init() {
     render_date_label(date_day_row);
     render_day_label(date_day_row);
 
-    // Add an event handler for all possible events.
-    lv_obj_add_event_cb(home_screen, home_screen_event, LV_EVENT_ALL, NULL);
-}
-
-void home_screen_event(lv_event_t * event) {
-    lv_event_code_t event_code = lv_event_get_code(event);
-
-    // Handle gesture events using the callback
-    if (event_code == LV_EVENT_GESTURE) {
-        lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_active());
-
-        // Check for bottom-to-top gesture to open menu.
-        if (dir == LV_DIR_TOP) {
-            // Initialize menu screen if not already done.
-            if (!lv_obj_is_valid(menu_screen)) {
-                menu_screen_init();
-            }
-            // Create a smooth slide transition from right to left
-            lv_screen_load_anim(menu_screen, LV_SCR_LOAD_ANIM_MOVE_TOP, 300, 0, false);
-        }
-    }
+    // The gesture to open the menu is bound by the navigation.
 }
 
 void render_clock_label(lv_obj_t *flex_element) {
-    label_clock = lv_label_create(flex_element);
-    lv_obj_set_width(label_clock, LV_SIZE_CONTENT);
-    lv_obj_set_height(label_clock, LV_SIZE_CONTENT);
-    lv_label_set_text(label_clock, "HH:mm");
-
-    lv_obj_set_style_text_letter_space(label_clock, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(label_clock, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(label_clock, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_decor(label_clock, LV_TEXT_DECOR_NONE, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(label_clock, &lv_font_montserrat_46, LV_PART_MAIN | LV_STATE_DEFAULT);
+    label_clock = digit_clock_create(flex_element);
 }
 
 void render_date_label(lv_obj_t *flex_element) {
     label_date = lv_label_create(flex_element);
     lv_label_set_text(label_date, "YYYY-MM-DD");
-    lv_obj_set_style_text_font(label_date, &lv_font_montserrat_18, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_style(label_date, get_widget_style_title(), LV_PART_MAIN);
 }
 
 void render_day_label(lv_obj_t *flex_element) {
     label_day = lv_label_create(flex_element);
     lv_label_set_text(label_day, "DAY");
-    lv_obj_set_style_text_font(label_day, &lv_font_montserrat_18, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_style(label_day, get_widget_style_title(), LV_PART_MAIN);
 }
 
 uint8_t home_screen_set_clock(uint8_t hour, uint8_t minute) {
     // Check if the label_clock is NULL.
     if (label_clock == NULL) return 1;
-    // Set the text of the label_clock to the current time in 24-hour format.
-    lv_label_set_text_fmt(label_clock, "%02d:%02d", hour, minute);
-    // Update the display.
-    lv_disp_flush_ready(lv_disp_get_default());
+    // Skip the label rewrite if the same time is already shown.
+    clock_update_count++;
+    if (shown_clock_minutes == hour * 60 + minute) {
+        clock_redundant_update_count++;
+        return 0;
+    }
+    shown_clock_minutes = hour * 60 + minute;
+    // Set the digits of the label_clock to the current time in 24-hour format. Only the changed
+    // digits are redrawn.
+    clock_changed_cell_count += digit_clock_set_time(label_clock, hour, minute);
     return 0;
 }
 
+void home_screen_get_clock_stats(uint32_t *update_count, uint32_t *redundant_update_count,
+                                 uint32_t *changed_cell_count) {
+    *update_count = clock_update_count;
+    *redundant_update_count = clock_redundant_update_count;
+    *changed_cell_count = clock_changed_cell_count;
+}
+
+void home_screen_set_ambient(bool ambient) {
+    // The ambient layout is the white clock on black, without the date and the day.
+    if (ambient) {
+        lv_obj_add_flag(date_day_row, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_remove_flag(date_day_row, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
 uint8_t home_screen_set_date(uint16_t year, uint8_t month, uint8_t day) {
     // Check if the label_date is NULL.
     if (label_date == NULL) return 1;
     // Set the text of the label_date to the current date in "YYYY-MM-DD" format.
     lv_label_set_text_fmt(label_date, "%04u-%02d-%02d", year,  month, day);
-    // Update the display.
-    lv_disp_flush_ready(lv_disp_get_default());
     return 0;
 }
 
@@ -112,7 +116,5 @@ uint8_t home_screen_set_day(uint8_t day_no) {
     if (label_day == NULL) return 1;
     // Set the text of the label_day to the 3 character day name.
     lv_label_set_text(label_day, weekdays[day_no]);
-    // Update the display.
-    lv_disp_flush_ready(lv_disp_get_default());
     return 0;
 }
\ No newline at end of file
@@ -18,9 +18,8 @@ extern "C" {
 // The screen object to be used in the userinterface.
 extern lv_obj_t *home_screen;
 
-// The init and event functions for the screen.
+// The init function for the screen. Its gestures are bound by the navigation.
 void home_screen_init();
-void home_screen_event(lv_event_t * e);
 
 // Render labels.
 void render_clock_label(lv_obj_t *flex_element);
@@ -32,6 +31,14 @@ uint8_t home_screen_set_clock(uint8_t hour, uint8_t minute);
 uint8_t home_screen_set_date(uint16_t year, uint8_t month, uint8_t day);
 uint8_t home_screen_set_day(uint8_t day_no);
 
+// Switch between the full layout and the minimal one of the ambient mode.
+void home_screen_set_ambient(bool ambient);
+
+// Get the number of clock updates, how many of them did not change the shown time, and the number of
+// the redrawn digits.
+void home_screen_get_clock_stats(uint32_t *update_count, uint32_t *redundant_update_count,
+                                 uint32_t *changed_cell_count);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
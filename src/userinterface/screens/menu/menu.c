@@ -5,54 +5,51 @@
  * @maintainer electricalgorithm @ github
  */
 
- #include <zephyr/logging/log.h>
+#include <zephyr/logging/log.h>
 #include "lvgl.h"
 
 #include "misc/lv_event.h"
 #include "userinterface/userinterface.h"
+#include "userinterface/appregistry.h"
 #include "userinterface/utils.h"
-#include "userinterface/screens/home/home.h"
-
-// Define the maximum number of applications allowed.
-#define MAX_APPLICATIONS 10
+#include "userinterface/styles/widgetstyle.h"
+#include "userinterface/navigation.h"
 
 // Create a logger.
 LOG_MODULE_REGISTER(ZephyrWatch_UI_Menu, LOG_LEVEL_INF);
 
-// Structure to hold application information
-typedef struct {
-    lv_obj_t *screen;
-    char *name;
-    bool is_registered;
-} application_t;
+/* The list is virtualized: only the rows which fit in the list and a spare one are created, and
+ * they are rebound to the applications as the list scrolls. A spacer as tall as all the rows gives
+ * the list its scroll range. The row showing the application at an index is index % row_count, so
+ * scrolling by a row rebinds only one of them.
+ */
+#define MENU_ROW_HEIGHT 45
+#define MENU_ROW_GAP 8
+#define MENU_ROW_PITCH (MENU_ROW_HEIGHT + MENU_ROW_GAP)
+#define MENU_MAX_ROWS 8
 
-// Array to store registered applications
-static application_t applications[MAX_APPLICATIONS];
-static uint8_t application_count = 0;
+// A recycled row of the list, and the index of the application it shows.
+typedef struct {
+    lv_obj_t *button;
+    lv_obj_t *label;
+    int32_t app_index;
+} menu_row_t;
 
 // The screen container.
 lv_obj_t *menu_screen;
 static lv_obj_t *menu_list;
+static lv_obj_t *menu_list_spacer;
 
-/**
- * Register an application to be displayed in the menu
- * @param screen The screen object for the application
- * @param name The name of the application to display
- * @return 0 on success, -1 if maximum applications reached
- */
-int register_application(lv_obj_t *screen, char *name) {
-    if (application_count >= MAX_APPLICATIONS) {
-        LOG_ERR("Maximum number of applications reached.");
-        return -1; // Maximum applications reached
-    }
+// The rows of the list, and the registry version they are bound to.
+static menu_row_t menu_rows[MENU_MAX_ROWS];
+static uint32_t menu_row_count = 0;
+static uint32_t bound_registry_version = 0;
+static uint32_t rebind_count = 0;
 
-    applications[application_count].screen = screen;
-    applications[application_count].name = name;
-    applications[application_count].is_registered = true;
-    application_count++;
-    LOG_DBG("Application registered successfully: %s", name);
-    return 0;
-}
+// Prototype definition of internal static functions.
+static void create_menu_item(lv_obj_t *parent, menu_row_t *row);
+static void bind_menu_item(menu_row_t *row, int32_t app_index);
+static void update_menu_rows();
 
 /* MENU_SCREEN_EVENT
  * Event handler for menu screen gestures. It is used to detect non-list events.
@@ -61,13 +58,9 @@ void menu_screen_event(lv_event_t * event) {
     lv_event_code_t event_code = lv_event_get_code(event);
     // If double clicked, return to home with slide back effect..
     if (event_code == LV_EVENT_DOUBLE_CLICKED) {
-        // Home screen is never deleted, but check it for any case. 
-        if (!lv_obj_is_valid(home_screen)) {
-            home_screen_init();
-        }
-        // Go back to home screen with slide down animation.
-        // Do not delete the screen since register_application will generate new items.
-        lv_screen_load_anim(home_screen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 300, 0, false);
+        // Go back to home screen with the reverse of the slide up animation. The menu screen is
+        // kept until the screen manager evicts it; its rows are rebound when it is loaded again.
+        navigation_pop();
     }
 }
 
@@ -79,64 +72,105 @@ static void menu_item_event_handler(lv_event_t *event) {
     LOG_DBG("Menu-Items - Event code: %d", code);
 
     if (code == LV_EVENT_CLICKED) {
-        uint8_t *app_index = (uint8_t*)lv_event_get_user_data(event);
-        LOG_DBG("Clicked app index: %u", *app_index);
+        menu_row_t *row = lv_event_get_user_data(event);
+        const application_t *application = get_application(row->app_index);
+        LOG_DBG("Clicked app index: %d", row->app_index);
 
-        if (*app_index < application_count && applications[*app_index].screen != NULL) {
+        if (application != NULL && application->screen != NULL) {
             // Switch to the selected application screen
-            LOG_DBG("Switching to application: %s", applications[*app_index].name);
-            lv_screen_load(applications[*app_index].screen);
+            LOG_DBG("Switching to application: %s", application->id);
+            lv_screen_load(application->screen);
         }
     }
 }
 
+/* MENU_LIST_EVENT_HANDLER
+ * Rebind the rows when the list is scrolled, or when the menu is loaded after the registry changed.
+ */
+static void menu_list_event_handler(lv_event_t *event) {
+    update_menu_rows();
+}
+
 /* CREATE_MENU_ITEM
- * Create one menu item in a list. Each menu item corresponds to an application and presented
- * as buttons.
+ * Create one row of the list, presented as a button. It is bound to an application later.
  */
-static void create_menu_item(lv_obj_t *parent, const char *app_name, uint32_t app_index) {
+static void create_menu_item(lv_obj_t *parent, menu_row_t *row) {
     // Create a button for the menu item
     lv_obj_t *btn = lv_button_create(parent);
     lv_obj_set_width(btn, lv_pct(95));
-    lv_obj_set_height(btn, 45);
-
-    // Remove centering to let flex layout handle positioning
-    lv_obj_set_align(btn, LV_ALIGN_CENTER);
+    lv_obj_set_height(btn, MENU_ROW_HEIGHT);
 
-    // Style the button
-    lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
-    lv_obj_set_style_border_width(btn, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(btn, lv_color_hex(0x555555), LV_PART_MAIN);
+    // The rows are placed by their index, not by a layout.
+    lv_obj_set_align(btn, LV_ALIGN_TOP_MID);
 
-    // Add hover effect
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0x404040), LV_PART_MAIN | LV_STATE_PRESSED);
+    // Style the button, with a hover effect
+    lv_obj_add_style(btn, get_widget_style_card(), LV_PART_MAIN);
+    lv_obj_add_style(btn, get_widget_style_card_pressed(), LV_PART_MAIN | LV_STATE_PRESSED);
 
     // Create label for the button
     lv_obj_t *label = lv_label_create(btn);
-    lv_label_set_text(label, app_name);
-    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_add_style(label, get_widget_style_text(), LV_PART_MAIN);
     lv_obj_center(label);
 
-    // Add event handler with application index as user data.
-    static uint32_t indices[MAX_APPLICATIONS];
-    indices[app_index] = app_index;
-    lv_obj_add_event_cb(btn, menu_item_event_handler, LV_EVENT_CLICKED, &indices[app_index]);
-    LOG_DBG("Menu item created for app index: %d, app name: %s.", app_index, app_name);
+    // Add event handler with the row as user data.
+    lv_obj_add_event_cb(btn, menu_item_event_handler, LV_EVENT_CLICKED, row);
+    lv_obj_add_flag(btn, LV_OBJ_FLAG_HIDDEN);
+
+    row->button = btn;
+    row->label = label;
+    row->app_index = -1;
 }
 
-/* RENDER_MENU_ITEMS
- * Render all registered applications as menu items.
+/* BIND_MENU_ITEM
+ * Show the application at the index on the row, or hide the row if there is no application.
  */
-static void render_menu_items() {
-    for (uint8_t i = 0; i < application_count; i++) {
-        if (applications[i].is_registered) {
-            create_menu_item(menu_list, applications[i].name, i);
+static void bind_menu_item(menu_row_t *row, int32_t app_index) {
+    const application_t *application = get_application(app_index);
+    row->app_index = app_index;
+    rebind_count++;
+
+    if (application == NULL) {
+        lv_obj_add_flag(row->button, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    lv_obj_set_y(row->button, app_index * MENU_ROW_PITCH);
+    // The names outlive their registration, so the label does not copy them.
+    lv_label_set_text_static(row->label, application->name);
+    lv_obj_remove_flag(row->button, LV_OBJ_FLAG_HIDDEN);
+    LOG_DBG("Menu row bound to app index: %d, app name: %s.", app_index, application->name);
+}
+
+/* UPDATE_MENU_ROWS
+ * Bind the rows to the applications from the first visible one. The rows which already show their
+ * application are left as they are. A registry change resizes the list and rebinds all rows.
+ */
+static void update_menu_rows() {
+    if (bound_registry_version != get_application_registry_version()) {
+        bound_registry_version = get_application_registry_version();
+        uint32_t count = get_application_count();
+        lv_obj_set_height(menu_list_spacer, count ? count * MENU_ROW_PITCH - MENU_ROW_GAP : 0);
+        for (uint32_t i = 0; i < menu_row_count; i++) {
+            menu_rows[i].app_index = -1;
+        }
+    }
+
+    int32_t first_index = MAX(lv_obj_get_scroll_y(menu_list), 0) / MENU_ROW_PITCH;
+    for (int32_t app_index = first_index; app_index < first_index + (int32_t)menu_row_count; app_index++) {
+        menu_row_t *row = &menu_rows[app_index % menu_row_count];
+        if (row->app_index != app_index) {
+            bind_menu_item(row, app_index);
         }
     }
 }
 
+/* GET_MENU_STATS
+ * Return the number of the row objects, and how many times they are bound to an application.
+ */
+void get_menu_stats(uint32_t *row_count, uint32_t *row_bind_count) {
+    *row_count = menu_row_count;
+    *row_bind_count = rebind_count;
+}
+
 /* MENU_SCREEN_INIT 
  * Create the menu screen using LVGL definitions.
  */
@@ -151,14 +185,12 @@ void menu_screen_init() {
     lv_obj_t *title_row = create_row(main_column, 100, 15);
     lv_obj_t *title_label = lv_label_create(title_row);
     lv_label_set_text(title_label, "Menu");
-    lv_obj_set_style_text_color(title_label, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(title_label, &lv_font_montserrat_18, LV_PART_MAIN);
+    lv_obj_add_style(title_label, get_widget_style_title(), LV_PART_MAIN);
     lv_obj_center(title_label);
 
     // Create a scrollable list container for menu items
     menu_list = create_column(main_column, 100, 80);
     lv_obj_set_style_pad_all(menu_list, 10, LV_PART_MAIN);
-    lv_obj_set_style_pad_row(menu_list, 8, LV_PART_MAIN);
 
     // Enable scrolling for the menu list
     lv_obj_set_scroll_dir(menu_list, LV_DIR_VER);
@@ -170,18 +202,27 @@ void menu_screen_init() {
     lv_obj_remove_flag(menu_list, LV_OBJ_FLAG_SCROLL_MOMENTUM);
     lv_obj_add_flag(menu_list, LV_OBJ_FLAG_SCROLLABLE);
 
-    // Set flex layout to column with proper alignment
-    lv_obj_set_flex_flow(menu_list, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(menu_list, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-
-    // Register some example applications
-    register_application(NULL, "Settings");
-    register_application(NULL, "Stopwatch");
-    register_application(NULL, "Weather");
-    register_application(NULL, "Music");
+    // The rows are placed by their index, so the list has no layout. The invisible spacer sets the
+    // scroll range of all the rows.
+    lv_obj_set_layout(menu_list, LV_LAYOUT_NONE);
+    menu_list_spacer = lv_obj_create(menu_list);
+    lv_obj_remove_style_all(menu_list_spacer);
+    lv_obj_remove_flag(menu_list_spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(menu_list_spacer, 1, 0);
+
+    // Create the rows which fit in the list, and a spare one for the row entering while scrolling.
+    lv_obj_update_layout(menu_screen);
+    int32_t list_height = lv_obj_get_content_height(menu_list);
+    menu_row_count = MIN((list_height + MENU_ROW_PITCH - 1) / MENU_ROW_PITCH + 1, MENU_MAX_ROWS);
+    for (uint32_t i = 0; i < menu_row_count; i++) {
+        create_menu_item(menu_list, &menu_rows[i]);
+    }
 
-    // Render all registered applications
-    render_menu_items();
+    // Bind the rows, and rebind them on scrolling, or on loading after a registry change.
+    bound_registry_version = get_application_registry_version() - 1;
+    update_menu_rows();
+    lv_obj_add_event_cb(menu_list, menu_list_event_handler, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(menu_screen, menu_list_event_handler, LV_EVENT_SCREEN_LOAD_START, NULL);
 
     // Add spacing between elements
     lv_obj_set_style_pad_row(main_column, 5, LV_PART_MAIN);
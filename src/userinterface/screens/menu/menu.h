@@ -23,13 +23,8 @@ void menu_screen_init();
 /* Event handler for menu screen gestures. It is used to detect non-list events. */
 void menu_screen_event(lv_event_t * event);
 
-/**
- * Register an application to be displayed in the menu
- * @param screen The screen object for the application
- * @param name The name of the application to display
- * @return 0 on success, -1 if maximum applications reached
- */
-int register_application(lv_obj_t *screen, char *name);
+/* Get the number of the list's row objects, and how many times they are bound to an application. */
+void get_menu_stats(uint32_t *row_count, uint32_t *row_bind_count);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -0,0 +1,362 @@
+/** Screen Transitions for ZephyrWatch.
+ * A slide renders the hidden screen into a snapshot, loads the shown screen without an animation, and
+ * renders it into another snapshot. The shown screen is loaded once, so its load hooks run once, and
+ * it is snapshotted as they left it. An opaque overlay on the shown screen holds the snapshots as two
+ * images, and an animation moves them as LVGL's screen load animation moves the screens. Since the
+ * overlay covers the display, LVGL draws only the overlay, not the widgets under it. At the end of
+ * the slide, the overlay is deleted with the snapshots. A snapshot of the whole display does not fit
+ * in the LVGL heap, so they are allocated from the system heap; if they do not fit there either, LVGL
+ * renders the screens live.
+ *
+ * A transition is measured from its start to the end of the frame after which the shown screen is
+ * active and not animated. Only the frames which flushed pixels are counted.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "userinterface/screentransition.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_UI_ScreenTransition, LOG_LEVEL_INF);
+
+// The screens are rendered into the snapshots in the display's color format.
+#define TRANSITION_COLOR_FORMAT LV_COLOR_FORMAT_RGB565
+
+/* A slide animation. The shown screen starts, and the hidden one ends, away from the display by the
+ * given number of screen sizes along the axis.
+ */
+typedef struct {
+    lv_screen_load_anim_t animation;
+    bool vertical;
+    int8_t to_start;
+    int8_t from_end;
+    bool from_on_top;
+} slide_t;
+
+typedef struct {
+    const slide_t *slide;
+    screen_id_t to;
+    int32_t distance;
+    lv_obj_t *overlay;  // The overlay with the images, or NULL if no slide is running.
+    lv_obj_t *from_image;
+    lv_obj_t *to_image;
+    lv_draw_buf_t from_snapshot;
+    lv_draw_buf_t to_snapshot;
+} slide_state_t;
+
+typedef struct {
+    bool running;
+    bool flushed;
+    screen_id_t from;
+    screen_id_t to;
+    uint32_t start_ms;
+    screen_transition_stats_t stats;
+} measurement_t;
+
+static const slide_t slides[] = {
+    { LV_SCR_LOAD_ANIM_OVER_LEFT, false, 1, 0, false },
+    { LV_SCR_LOAD_ANIM_OVER_RIGHT, false, -1, 0, false },
+    { LV_SCR_LOAD_ANIM_OVER_TOP, true, 1, 0, false },
+    { LV_SCR_LOAD_ANIM_OVER_BOTTOM, true, -1, 0, false },
+    { LV_SCR_LOAD_ANIM_MOVE_LEFT, false, 1, -1, false },
+    { LV_SCR_LOAD_ANIM_MOVE_RIGHT, false, -1, 1, false },
+    { LV_SCR_LOAD_ANIM_MOVE_TOP, true, 1, -1, false },
+    { LV_SCR_LOAD_ANIM_MOVE_BOTTOM, true, -1, 1, false },
+    { LV_SCR_LOAD_ANIM_OUT_LEFT, false, 0, -1, true },
+    { LV_SCR_LOAD_ANIM_OUT_RIGHT, false, 0, 1, true },
+    { LV_SCR_LOAD_ANIM_OUT_TOP, true, 0, -1, true },
+    { LV_SCR_LOAD_ANIM_OUT_BOTTOM, true, 0, 1, true },
+};
+
+static bool snapshots_enabled = true;
+static slide_state_t slide_state;
+static measurement_t measurement;
+static screen_transition_stats_t last_stats;
+
+/* Prototype definition of internal static functions. */
+static const slide_t* find_slide(lv_screen_load_anim_t animation);
+static int start_slide(lv_obj_t *from, lv_obj_t *to, screen_id_t id, const slide_t *slide,
+                       uint32_t time_ms);
+static int take_snapshots(lv_obj_t *from, lv_obj_t *to, screen_id_t id);
+static lv_obj_t* create_image(lv_obj_t *parent, lv_draw_buf_t *snapshot);
+static void move_images(void *overlay, int32_t value);
+static void slide_completed_callback(lv_anim_t *anim);
+static void finish_slide();
+static void overlay_event_callback(lv_event_t *event);
+static void display_event_callback(lv_event_t *event);
+
+/* SCREEN_TRANSITION_INIT
+ * Count the frames of the transitions.
+ */
+void screen_transition_init() {
+    lv_display_t *display = lv_display_get_default();
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_REFR_READY, NULL);
+}
+
+/* SCREEN_TRANSITION_START
+ * Slide the snapshots of the screens if the animation is a slide and they fit in the RAM, otherwise
+ * let LVGL load the screen with the animation.
+ */
+int screen_transition_start(screen_id_t id, lv_screen_load_anim_t animation, uint32_t time_ms) {
+    if (id >= SCREEN_COUNT) {
+        return -EINVAL;
+    }
+    if (slide_state.overlay != NULL) {
+        finish_slide();
+    }
+
+    lv_obj_t *from = lv_screen_active();
+    lv_obj_t *to = screen_manager_get(id);
+    if (to == from) {
+        return 0;
+    }
+
+    measurement.running = true;
+    measurement.flushed = false;
+    measurement.from = screen_manager_get_active();
+    measurement.to = id;
+    measurement.start_ms = k_uptime_get_32();
+    measurement.stats.frame_count = 0;
+
+    const slide_t *slide = find_slide(animation);
+    if (snapshots_enabled && slide != NULL && from != NULL && time_ms > 0 &&
+        start_slide(from, to, id, slide, time_ms) == 0) {
+        measurement.stats.snapshot = true;
+        return 0;
+    }
+
+    // If the shown screen is already loaded for the slide, it is only marked as shown.
+    measurement.stats.snapshot = false;
+    return screen_manager_show(id, animation, time_ms);
+}
+
+/* SCREEN_TRANSITION_SET_SNAPSHOTS
+ * Enable or disable the snapshots of the slides.
+ */
+void screen_transition_set_snapshots(bool enabled) {
+    snapshots_enabled = enabled;
+}
+
+/* SCREEN_TRANSITION_IS_RUNNING
+ * Return whether the last transition is not finished yet.
+ */
+bool screen_transition_is_running() {
+    return measurement.running;
+}
+
+/* SCREEN_TRANSITION_GET_STATS
+ * Return the frames of the last finished transition.
+ */
+void screen_transition_get_stats(screen_transition_stats_t *stats) {
+    *stats = last_stats;
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* FIND_SLIDE
+ * Return the slide of the animation, or NULL if it is not a slide.
+ */
+static const slide_t* find_slide(lv_screen_load_anim_t animation) {
+    for (uint32_t i = 0; i < ARRAY_SIZE(slides); i++) {
+        if (slides[i].animation == animation) {
+            return &slides[i];
+        }
+    }
+    return NULL;
+}
+
+/* START_SLIDE
+ * Take the snapshots, cover the shown screen with their images, and start moving them.
+ */
+static int start_slide(lv_obj_t *from, lv_obj_t *to, screen_id_t id, const slide_t *slide,
+                       uint32_t time_ms) {
+    int ret = take_snapshots(from, to, id);
+    if (ret) {
+        return ret;
+    }
+
+    // The overlay ignores the layout of the screen, and its opaque background hides the widgets.
+    lv_obj_t *overlay = lv_obj_create(to);
+    lv_obj_remove_style_all(overlay);
+    lv_obj_add_flag(overlay, LV_OBJ_FLAG_FLOATING);
+    lv_obj_remove_flag(overlay, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(overlay, 0, 0);
+    lv_obj_set_size(overlay, slide_state.from_snapshot.header.w, slide_state.from_snapshot.header.h);
+    lv_obj_set_style_bg_color(overlay, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_add_event_cb(overlay, overlay_event_callback, LV_EVENT_DELETE, NULL);
+
+    // The image of the screen on top is created last.
+    if (slide->from_on_top) {
+        slide_state.to_image = create_image(overlay, &slide_state.to_snapshot);
+        slide_state.from_image = create_image(overlay, &slide_state.from_snapshot);
+    } else {
+        slide_state.from_image = create_image(overlay, &slide_state.from_snapshot);
+        slide_state.to_image = create_image(overlay, &slide_state.to_snapshot);
+    }
+
+    slide_state.slide = slide;
+    slide_state.to = id;
+    slide_state.distance = slide->vertical ? slide_state.from_snapshot.header.h
+                                           : slide_state.from_snapshot.header.w;
+    slide_state.overlay = overlay;
+    move_images(overlay, 0);
+
+    lv_anim_t anim;
+    lv_anim_init(&anim);
+    lv_anim_set_var(&anim, overlay);
+    lv_anim_set_values(&anim, 0, slide_state.distance);
+    lv_anim_set_duration(&anim, time_ms);
+    lv_anim_set_exec_cb(&anim, move_images);
+    lv_anim_set_completed_cb(&anim, slide_completed_callback);
+    lv_anim_start(&anim);
+    return 0;
+}
+
+/* TAKE_SNAPSHOTS
+ * Render the hidden screen into its snapshot, load the shown screen, and render it into the other
+ * snapshot. The snapshots are freed on failure; the shown screen stays loaded if only its own
+ * snapshot fails.
+ */
+static int take_snapshots(lv_obj_t *from, lv_obj_t *to, screen_id_t id) {
+    lv_display_t *display = lv_display_get_default();
+    int32_t width = lv_display_get_horizontal_resolution(display);
+    int32_t height = lv_display_get_vertical_resolution(display);
+    uint32_t stride = lv_draw_buf_width_to_stride(width, TRANSITION_COLOR_FORMAT);
+    uint32_t size = stride * height;
+
+    void *from_data = malloc(size);
+    void *to_data = malloc(size);
+    if (from_data == NULL || to_data == NULL) {
+        free(from_data);
+        free(to_data);
+        LOG_DBG("No RAM for the snapshots of %u bytes, the screens are rendered live.", 2 * size);
+        return -ENOMEM;
+    }
+    lv_draw_buf_init(&slide_state.from_snapshot, width, height, TRANSITION_COLOR_FORMAT, stride,
+                     from_data, size);
+    lv_draw_buf_init(&slide_state.to_snapshot, width, height, TRANSITION_COLOR_FORMAT, stride, to_data,
+                     size);
+
+    if (lv_snapshot_take_to_draw_buf(from, TRANSITION_COLOR_FORMAT, &slide_state.from_snapshot) !=
+        LV_RESULT_OK) {
+        free(from_data);
+        free(to_data);
+        LOG_WRN("Failed to take the snapshot of the hidden screen, the screens are rendered live.");
+        return -EIO;
+    }
+
+    // The shown screen is loaded before its snapshot, so its load hooks prepare it, e.g. the menu
+    // binds its rows. They do not run again at the end of the slide.
+    screen_manager_show(id, LV_SCR_LOAD_ANIM_NONE, 0);
+    lv_obj_update_layout(to);
+
+    if (lv_snapshot_take_to_draw_buf(to, TRANSITION_COLOR_FORMAT, &slide_state.to_snapshot) !=
+        LV_RESULT_OK) {
+        free(from_data);
+        free(to_data);
+        LOG_WRN("Failed to take the snapshot of the shown screen, it is loaded without a slide.");
+        return -EIO;
+    }
+    return 0;
+}
+
+/* CREATE_IMAGE
+ * Create an image of the snapshot.
+ */
+static lv_obj_t* create_image(lv_obj_t *parent, lv_draw_buf_t *snapshot) {
+    lv_obj_t *image = lv_image_create(parent);
+    lv_image_set_src(image, snapshot);
+    lv_obj_remove_flag(image, LV_OBJ_FLAG_CLICKABLE);
+    return image;
+}
+
+/* MOVE_IMAGES
+ * Place the images at the given progress of the slide, from 0 to the size of the screen.
+ */
+static void move_images(void *overlay, int32_t value) {
+    const slide_t *slide = slide_state.slide;
+    int32_t to_position = slide->to_start * (slide_state.distance - value);
+    int32_t from_position = slide->from_end * value;
+
+    if (slide->vertical) {
+        lv_obj_set_y(slide_state.to_image, to_position);
+        lv_obj_set_y(slide_state.from_image, from_position);
+    } else {
+        lv_obj_set_x(slide_state.to_image, to_position);
+        lv_obj_set_x(slide_state.from_image, from_position);
+    }
+}
+
+/* SLIDE_COMPLETED_CALLBACK
+ * Uncover the live screen at the end of the slide.
+ */
+static void slide_completed_callback(lv_anim_t *anim) {
+    finish_slide();
+}
+
+/* FINISH_SLIDE
+ * Stop the slide, and delete the overlay with the snapshots. The shown screen is already loaded. It
+ * is also called from the animation's completed callback, where LVGL deletes its screens too.
+ */
+static void finish_slide() {
+    lv_obj_t *overlay = slide_state.overlay;
+
+    lv_anim_delete(overlay, move_images);
+    lv_obj_delete(overlay);
+}
+
+/* OVERLAY_EVENT_CALLBACK
+ * Free the snapshots with the overlay, which is also deleted with the shown screen. The images are
+ * not drawn anymore, but they are dropped from LVGL's image cache, since the next snapshots may get
+ * the same addresses.
+ */
+static void overlay_event_callback(lv_event_t *event) {
+    slide_state.overlay = NULL;
+    lv_image_cache_drop(&slide_state.from_snapshot);
+    lv_image_cache_drop(&slide_state.to_snapshot);
+    free(slide_state.from_snapshot.data);
+    free(slide_state.to_snapshot.data);
+    slide_state.from_snapshot.data = NULL;
+    slide_state.to_snapshot.data = NULL;
+}
+
+/* DISPLAY_EVENT_CALLBACK
+ * Count the frames of the running transition, and log its frame rate when it is finished.
+ */
+static void display_event_callback(lv_event_t *event) {
+    if (!measurement.running) {
+        return;
+    }
+    if (lv_event_get_code(event) == LV_EVENT_FLUSH_START) {
+        measurement.flushed = true;
+        return;
+    }
+    if (!measurement.flushed) {
+        return;
+    }
+    measurement.flushed = false;
+    measurement.stats.frame_count++;
+
+    lv_obj_t *active = lv_screen_active();
+    if (screen_manager_get_active() != measurement.to || slide_state.overlay != NULL ||
+        lv_anim_get(active, NULL) != NULL) {
+        return;
+    }
+
+    measurement.running = false;
+    measurement.stats.duration_ms = k_uptime_get_32() - measurement.start_ms;
+    last_stats = measurement.stats;
+    LOG_INF("%s to %s: %s transition, %u frames in %u ms, %u FPS.",
+            screen_manager_get_name(measurement.from), screen_manager_get_name(measurement.to),
+            last_stats.snapshot ? "snapshot" : "live", last_stats.frame_count, last_stats.duration_ms,
+            last_stats.duration_ms ? last_stats.frame_count * 1000 / last_stats.duration_ms : 0);
+}
@@ -0,0 +1,56 @@
+/** Screen Transitions for ZephyrWatch.
+ * Plays the screen load animations. The slide animations render both screens once into snapshots,
+ * and move the two images over the loaded screen instead of rendering the widgets every frame. The
+ * other animations, or all of them when the RAM is short for two snapshots, are played by LVGL with
+ * live rendering. The frame rate of each transition is logged. All functions are only called by the
+ * LVGL-owner thread.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_SCREENTRANSITION_H
+#define _SMART_WATCH_UI_SCREENTRANSITION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#include "userinterface/screenmanager.h"
+
+/* The frames of the last finished transition. */
+typedef struct {
+    bool snapshot;  // Whether the screens were animated as snapshots.
+    uint32_t frame_count;
+    uint32_t duration_ms;
+} screen_transition_stats_t;
+
+/* Start measuring the transitions. The screen manager must be initialized before. */
+void screen_transition_init();
+
+/**
+ * Show a screen with the animation. A running transition is finished right away before.
+ * @param id The screen to show.
+ * @param animation The screen load animation.
+ * @param time_ms The duration of the animation.
+ * @return 0 on success, -EINVAL if the screen is unknown.
+ */
+int screen_transition_start(screen_id_t id, lv_screen_load_anim_t animation, uint32_t time_ms);
+
+/* Use snapshots for the slide animations, or always render live, e.g. to compare them. */
+void screen_transition_set_snapshots(bool enabled);
+
+/* Return whether a transition is not finished yet, including its last frame. */
+bool screen_transition_is_running();
+
+/* Get the frames of the last finished transition. */
+void screen_transition_get_stats(screen_transition_stats_t *stats);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
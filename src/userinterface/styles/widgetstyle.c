@@ -1,6 +1,7 @@
 /** Widget styling implementation for LVGL components.
- * Implements shared widget styles including borderless styles for clean UI appearance across the
- * smartwatch interface.
+ * Implements the shared style sheet of the smartwatch interface. The styles are static and applied
+ * by reference, so the widgets do not allocate a local style entry from the LVGL heap for each
+ * property.
  *
  * @license GNU v3
  * @maintainer electricalgorithm @ github
@@ -9,7 +10,23 @@
 #include "lvgl.h"
 #include "userinterface/styles/widgetstyle.h"
 
+// The colors of the cards and the digit boxes.
+#define WIDGET_STYLE_CARD_COLOR 0x2E2E2E
+#define WIDGET_STYLE_CARD_PRESSED_COLOR 0x404040
+#define WIDGET_STYLE_BORDER_COLOR 0x555555
+
 static lv_style_t style_no_border;
+static lv_style_t style_flex_column;
+static lv_style_t style_flex_row;
+static lv_style_t style_card;
+static lv_style_t style_card_pressed;
+static lv_style_t style_digit_row;
+static lv_style_t style_digit_box;
+static lv_style_t style_title;
+static lv_style_t style_text;
+
+/* Prototype definition of internal static functions. */
+static void init_flex_style(lv_style_t *style, lv_flex_flow_t flow);
 
 void widget_style_init() {
     lv_style_init(&style_no_border);
@@ -26,8 +43,87 @@ void widget_style_init() {
 
     // Optional: remove padding if undesired
     lv_style_set_pad_all(&style_no_border, 0);
+
+    // Transparent, borderless flex containers with centered items.
+    init_flex_style(&style_flex_column, LV_FLEX_FLOW_COLUMN);
+    init_flex_style(&style_flex_row, LV_FLEX_FLOW_ROW);
+
+    // Rounded, bordered buttons of the lists.
+    lv_style_init(&style_card);
+    lv_style_set_radius(&style_card, 10);
+    lv_style_set_bg_color(&style_card, lv_color_hex(WIDGET_STYLE_CARD_COLOR));
+    lv_style_set_border_width(&style_card, 2);
+    lv_style_set_border_color(&style_card, lv_color_hex(WIDGET_STYLE_BORDER_COLOR));
+    lv_style_init(&style_card_pressed);
+    lv_style_set_bg_color(&style_card_pressed, lv_color_hex(WIDGET_STYLE_CARD_PRESSED_COLOR));
+
+    // A row of digit boxes, e.g. the pairing PIN.
+    init_flex_style(&style_digit_row, LV_FLEX_FLOW_ROW);
+    lv_style_set_pad_all(&style_digit_row, 15);
+    lv_style_set_pad_column(&style_digit_row, 8);
+
+    // A box holding a single digit.
+    lv_style_init(&style_digit_box);
+    lv_style_set_radius(&style_digit_box, 8);
+    lv_style_set_bg_color(&style_digit_box, lv_color_hex(WIDGET_STYLE_CARD_PRESSED_COLOR));
+    lv_style_set_bg_opa(&style_digit_box, LV_OPA_100);
+    lv_style_set_border_color(&style_digit_box, lv_color_hex(WIDGET_STYLE_BORDER_COLOR));
+    lv_style_set_border_width(&style_digit_box, 2);
+    lv_style_set_border_opa(&style_digit_box, LV_OPA_50);
+
+    // White texts: the titles in the large font, the others in the small font and centered.
+    lv_style_init(&style_title);
+    lv_style_set_text_color(&style_title, lv_color_white());
+    lv_style_set_text_font(&style_title, &lv_font_montserrat_18);
+    lv_style_init(&style_text);
+    lv_style_set_text_color(&style_text, lv_color_white());
+    lv_style_set_text_font(&style_text, &lv_font_montserrat_14);
+    lv_style_set_text_align(&style_text, LV_TEXT_ALIGN_CENTER);
 }
 
 const lv_style_t* get_widget_style_no_border() {
     return &style_no_border;
 }
+
+const lv_style_t* get_widget_style_flex_column() {
+    return &style_flex_column;
+}
+
+const lv_style_t* get_widget_style_flex_row() {
+    return &style_flex_row;
+}
+
+const lv_style_t* get_widget_style_card() {
+    return &style_card;
+}
+
+const lv_style_t* get_widget_style_card_pressed() {
+    return &style_card_pressed;
+}
+
+const lv_style_t* get_widget_style_digit_row() {
+    return &style_digit_row;
+}
+
+const lv_style_t* get_widget_style_digit_box() {
+    return &style_digit_box;
+}
+
+const lv_style_t* get_widget_style_title() {
+    return &style_title;
+}
+
+const lv_style_t* get_widget_style_text() {
+    return &style_text;
+}
+
+static void init_flex_style(lv_style_t *style, lv_flex_flow_t flow) {
+    lv_style_init(style);
+    lv_style_set_layout(style, LV_LAYOUT_FLEX);
+    lv_style_set_flex_flow(style, flow);
+    lv_style_set_flex_main_place(style, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_flex_cross_place(style, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_flex_track_place(style, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_border_width(style, 0);
+    lv_style_set_bg_opa(style, LV_OPA_TRANSP);
+}
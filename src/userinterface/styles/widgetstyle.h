@@ -3,7 +3,8 @@
 
 /** Widget styling interface for LVGL components.
  * Provides functions to initialize and access shared widget styles for consistent UI appearance
- * across the smartwatch interface.
+ * across the smartwatch interface. Apply them with lv_obj_add_style() instead of setting the same
+ * properties on each object.
  *
  * @license GNU v3
  * @maintainer electricalgorithm @ github
@@ -21,6 +22,22 @@ void widget_style_init();
 // Returns a pointer to a style without borders, for clean widget appearance
 const lv_style_t* get_widget_style_no_border();
 
+// Returns pointers to transparent, borderless flex column and row containers with centered items.
+const lv_style_t* get_widget_style_flex_column();
+const lv_style_t* get_widget_style_flex_row();
+
+// Returns pointers to the style of the list buttons, and of their pressed state.
+const lv_style_t* get_widget_style_card();
+const lv_style_t* get_widget_style_card_pressed();
+
+// Returns pointers to the styles of a row of digit boxes, and of a digit box.
+const lv_style_t* get_widget_style_digit_row();
+const lv_style_t* get_widget_style_digit_box();
+
+// Returns pointers to the white text styles of the titles, and of the other centered texts.
+const lv_style_t* get_widget_style_title();
+const lv_style_t* get_widget_style_text();
+
 #ifdef __cplusplus
 }
 #endif
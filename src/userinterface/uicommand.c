@@ -0,0 +1,252 @@
+/** UI command ring for the LVGL-owner thread.
+ * The ring is a bounded multi-producer single-consumer queue. Each slot has a sequence number: the
+ * producers claim a position with a compare-and-swap, write the slot and publish it by moving its
+ * sequence; the consumer takes the slots in order and hands them back for the next round. No
+ * producer ever blocks, so the commands can be posted from ISRs and the Bluetooth stack.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#include "userinterface/uicommand.h"
+
+LOG_MODULE_REGISTER(ZephyrWatch_UI_Command, LOG_LEVEL_INF);
+
+#define UI_COMMAND_RING_MASK (UI_COMMAND_RING_SIZE - 1)
+BUILD_ASSERT((UI_COMMAND_RING_SIZE & UI_COMMAND_RING_MASK) == 0, "The ring size must be a power of two.");
+
+// The statistics are logged after each this many commands.
+#define UI_COMMAND_STATS_LOG_PERIOD 256
+
+typedef struct {
+    atomic_t sequence;  // Equals the position when free, the position + 1 when published.
+    ui_command_t command;
+} ui_command_slot_t;
+
+static ui_command_slot_t ring[UI_COMMAND_RING_SIZE];
+static atomic_t enqueue_position = ATOMIC_INIT(0);
+static uint32_t dequeue_position = 0;  // Only accessed by the consumer.
+
+/* Duplicate clock commands are coalesced: the latest clock is kept aside, and at most one clock
+ * command is queued to apply it.
+ */
+static atomic_t pending_clock = ATOMIC_INIT(0);
+static atomic_t clock_queued = ATOMIC_INIT(0);
+
+// Wakes the LVGL-owner thread up when a command is posted.
+static K_SEM_DEFINE(wake_sem, 0, 1);
+
+// Statistics. The producer side counters are atomic, the rest is updated by the consumer only.
+static uint32_t depth_histogram[UI_COMMAND_HISTOGRAM_BUCKETS];
+static uint32_t latency_histogram[UI_COMMAND_HISTOGRAM_BUCKETS];
+
+/* The posts of the executed commands which wait for their refresh. A refresh follows within a
+ * refresh period, so the commands in between rarely exceed a ring full; the excess is not sampled.
+ */
+static uint32_t unrendered_post_cycles[UI_COMMAND_RING_SIZE];
+static uint32_t unrendered_count = 0;
+static uint32_t executed_count = 0;
+static atomic_t coalesced_count = ATOMIC_INIT(0);
+static atomic_t dropped_count = ATOMIC_INIT(0);
+
+/* Prototype definition of internal static functions. */
+static uint8_t histogram_bucket(uint32_t value);
+static void log_stats();
+
+/* UI_COMMAND_INIT
+ * Mark each slot free for its position of the first round. It is called during the start-up,
+ * before any other context posts.
+ */
+void ui_command_init() {
+    for (uint32_t i = 0; i < UI_COMMAND_RING_SIZE; i++) {
+        atomic_set(&ring[i].sequence, (atomic_val_t)i);
+    }
+    atomic_set(&enqueue_position, 0);
+    dequeue_position = 0;
+}
+
+/* UI_COMMAND_POST
+ * Claim the next free slot, write the command into it and publish it.
+ */
+int ui_command_post(const ui_command_t *command) {
+    uint32_t position = (uint32_t)atomic_get(&enqueue_position);
+    ui_command_slot_t *slot;
+    while (true) {
+        slot = &ring[position & UI_COMMAND_RING_MASK];
+        int32_t diff = (int32_t)((uint32_t)atomic_get(&slot->sequence) - position);
+
+        if (diff == 0) {
+            // The slot is free for this position, try to claim it.
+            if (atomic_cas(&enqueue_position, (atomic_val_t)position, (atomic_val_t)(position + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The slot of the previous round is not consumed yet, the ring is full.
+            atomic_inc(&dropped_count);
+            return -ENOMEM;
+        }
+        position = (uint32_t)atomic_get(&enqueue_position);
+    }
+
+    slot->command = *command;
+    slot->command.post_cycles = k_cycle_get_32();
+    atomic_set(&slot->sequence, (atomic_val_t)(position + 1));
+    k_sem_give(&wake_sem);
+    return 0;
+}
+
+/* UI_COMMAND_POST_SET_CLOCK
+ * Keep the clock aside, and queue a clock command only if there is none queued already.
+ */
+int ui_command_post_set_clock(uint8_t hour, uint8_t minute) {
+    atomic_set(&pending_clock, ((atomic_val_t)hour << 8) | minute);
+    if (!atomic_cas(&clock_queued, 0, 1)) {
+        atomic_inc(&coalesced_count);
+        return 0;
+    }
+
+    ui_command_t command = { .type = UI_COMMAND_SET_CLOCK };
+    int ret = ui_command_post(&command);
+    if (ret) {
+        atomic_clear(&clock_queued);
+    }
+    return ret;
+}
+
+int ui_command_post_set_date(uint16_t year, uint8_t month, uint8_t day) {
+    ui_command_t command = {
+        .type = UI_COMMAND_SET_DATE,
+        .date = { .year = year, .month = month, .day = day },
+    };
+    return ui_command_post(&command);
+}
+
+int ui_command_post_set_day(uint8_t weekday) {
+    ui_command_t command = {
+        .type = UI_COMMAND_SET_DAY,
+        .day = { .weekday = weekday },
+    };
+    return ui_command_post(&command);
+}
+
+int ui_command_post_show_pairing(const char *pin) {
+    ui_command_t command = { .type = UI_COMMAND_SHOW_PAIRING };
+    strncpy(command.pairing.pin, pin, sizeof(command.pairing.pin) - 1);
+    return ui_command_post(&command);
+}
+
+int ui_command_post_hide_pairing() {
+    ui_command_t command = { .type = UI_COMMAND_HIDE_PAIRING };
+    return ui_command_post(&command);
+}
+
+/* UI_COMMAND_DRAIN
+ * Execute the published commands in order. It stops at the first slot which is claimed but not
+ * published yet; the rest is executed in the next drain.
+ */
+uint32_t ui_command_drain(void (*handler)(const ui_command_t *command)) {
+    uint32_t depth = (uint32_t)atomic_get(&enqueue_position) - dequeue_position;
+    depth_histogram[histogram_bucket(depth)]++;
+
+    uint32_t count = 0;
+    while (true) {
+        ui_command_slot_t *slot = &ring[dequeue_position & UI_COMMAND_RING_MASK];
+        if ((uint32_t)atomic_get(&slot->sequence) != dequeue_position + 1) {
+            break;
+        }
+
+        ui_command_t command = slot->command;
+        atomic_set(&slot->sequence, (atomic_val_t)(dequeue_position + UI_COMMAND_RING_SIZE));
+        dequeue_position++;
+
+        // Apply the latest clock. The later clock posts queue a new command after this point.
+        if (command.type == UI_COMMAND_SET_CLOCK) {
+            atomic_clear(&clock_queued);
+            atomic_val_t clock = atomic_get(&pending_clock);
+            command.clock.hour = (uint8_t)(clock >> 8);
+            command.clock.minute = (uint8_t)clock;
+        }
+
+        handler(&command);
+        if (unrendered_count < ARRAY_SIZE(unrendered_post_cycles)) {
+            unrendered_post_cycles[unrendered_count++] = command.post_cycles;
+        }
+        count++;
+
+        if (++executed_count % UI_COMMAND_STATS_LOG_PERIOD == 0) {
+            log_stats();
+        }
+    }
+    return count;
+}
+
+/* UI_COMMAND_FRAME_READY
+ * Sample the latency of each command executed since the previous refresh, from its post until now.
+ */
+void ui_command_frame_ready() {
+    uint32_t now_cycles = k_cycle_get_32();
+    for (uint32_t i = 0; i < unrendered_count; i++) {
+        uint32_t latency_us = k_cyc_to_us_floor32(now_cycles - unrendered_post_cycles[i]);
+        latency_histogram[histogram_bucket(latency_us)]++;
+    }
+    unrendered_count = 0;
+}
+
+/* UI_COMMAND_WAIT
+ * Sleep until a command is posted, the owner is woken up, or the timeout expires. Returns 0 if it
+ * is woken up, -EAGAIN on timeout.
+ */
+int ui_command_wait(k_timeout_t timeout) {
+    return k_sem_take(&wake_sem, timeout);
+}
+
+/* UI_COMMAND_WAKE
+ * Wake the LVGL-owner thread up without a command, e.g. for an input event LVGL reads itself.
+ */
+void ui_command_wake() {
+    k_sem_give(&wake_sem);
+}
+
+/* UI_COMMAND_GET_STATS
+ * Copy the statistics. They are updated by the LVGL-owner thread, so a copy from another thread
+ * may be a few commands behind.
+ */
+void ui_command_get_stats(ui_command_stats_t *stats) {
+    memcpy(stats->depth_histogram, depth_histogram, sizeof(depth_histogram));
+    memcpy(stats->latency_histogram, latency_histogram, sizeof(latency_histogram));
+    stats->executed_count = executed_count;
+    stats->coalesced_count = (uint32_t)atomic_get(&coalesced_count);
+    stats->dropped_count = (uint32_t)atomic_get(&dropped_count);
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* HISTOGRAM_BUCKET
+ * Bucket 0 is for zero, bucket i is for [2^(i-1), 2^i), and the last bucket takes the rest.
+ */
+static uint8_t histogram_bucket(uint32_t value) {
+    uint8_t bucket = 0;
+    while (value && bucket < UI_COMMAND_HISTOGRAM_BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* LOG_STATS
+ * Log the histograms to check the queueing latency.
+ */
+static void log_stats() {
+    LOG_DBG("UI commands: %u executed, %u coalesced, %u dropped.", executed_count,
+            (uint32_t)atomic_get(&coalesced_count), (uint32_t)atomic_get(&dropped_count));
+    for (uint8_t i = 0; i < UI_COMMAND_HISTOGRAM_BUCKETS; i++) {
+        LOG_DBG("Bucket %u: depth %u, latency %u.", i, depth_histogram[i], latency_histogram[i]);
+    }
+}
@@ -0,0 +1,96 @@
+/** UI command ring for the LVGL-owner thread.
+ * LVGL is not thread-safe. The LVGL objects are only touched by the thread calling
+ * user_interface_task_handler(), and all the other contexts (work queues, the Bluetooth stack,
+ * ISRs) post typed commands to a bounded lock-free ring, which is drained by that thread.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _SMART_WATCH_UI_UICOMMAND_H
+#define _SMART_WATCH_UI_UICOMMAND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+// The capacity of the ring. It must be a power of two.
+#define UI_COMMAND_RING_SIZE 16
+
+// The number of the histogram buckets. Bucket 0 counts zeros, bucket i counts [2^(i-1), 2^i). The
+// last bucket of the latency starts at 65.5 ms, two refresh periods.
+#define UI_COMMAND_HISTOGRAM_BUCKETS 18
+
+/* The commands the LVGL-owner thread executes. */
+typedef enum {
+    UI_COMMAND_SET_CLOCK,
+    UI_COMMAND_SET_DATE,
+    UI_COMMAND_SET_DAY,
+    UI_COMMAND_SHOW_PAIRING,
+    UI_COMMAND_HIDE_PAIRING,
+} ui_command_type_t;
+
+typedef struct {
+    ui_command_type_t type;
+    uint32_t post_cycles;  // Cycle counter at the post, to measure the latency.
+    union {
+        struct { uint8_t hour; uint8_t minute; } clock;
+        struct { uint16_t year; uint8_t month; uint8_t day; } date;
+        struct { uint8_t weekday; } day;
+        struct { char pin[7]; } pairing;
+    };
+} ui_command_t;
+
+/* The queue statistics. The depth is sampled before each drain, and the latency is measured from
+ * the post to the end of the refresh which draws the command, in microseconds.
+ */
+typedef struct {
+    uint32_t depth_histogram[UI_COMMAND_HISTOGRAM_BUCKETS];
+    uint32_t latency_histogram[UI_COMMAND_HISTOGRAM_BUCKETS];
+    uint32_t executed_count;
+    uint32_t coalesced_count;  // Clock commands merged into an already queued one.
+    uint32_t dropped_count;    // Commands lost since the ring was full.
+} ui_command_stats_t;
+
+/* Initialize the ring. It must be called before the first post. */
+void ui_command_init();
+
+/* Post a command from any context. Returns 0 on success, -ENOMEM if the ring is full. */
+int ui_command_post(const ui_command_t *command);
+
+/* Post the clock to show. A queued clock command takes the latest clock instead of adding another. */
+int ui_command_post_set_clock(uint8_t hour, uint8_t minute);
+int ui_command_post_set_date(uint16_t year, uint8_t month, uint8_t day);
+int ui_command_post_set_day(uint8_t weekday);
+int ui_command_post_show_pairing(const char *pin);
+int ui_command_post_hide_pairing();
+
+/* Execute the queued commands with the handler. Only called from the LVGL-owner thread. Returns
+ * the number of the executed commands.
+ */
+uint32_t ui_command_drain(void (*handler)(const ui_command_t *command));
+
+/* Close the latency of the executed commands. Only called from the LVGL-owner thread, at the end of
+ * each refresh (LV_EVENT_REFR_READY).
+ */
+void ui_command_frame_ready();
+
+/* Sleep in the LVGL-owner thread until a command is posted, a wake-up or the timeout. Returns 0 if
+ * it is woken up, -EAGAIN on timeout.
+ */
+int ui_command_wait(k_timeout_t timeout);
+
+/* Wake the LVGL-owner thread up from any context. */
+void ui_command_wake();
+
+/* Copy the queue statistics. */
+void ui_command_get_stats(ui_command_stats_t *stats);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -8,20 +8,60 @@
 
 #include "lvgl.h"
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/input/input.h>
+#include <zephyr/zbus/zbus.h>
 
+#include "display/display.h"
+#include "display/roundflush.h"
 #include "userinterface/userinterface.h"
+#include "userinterface/uicommand.h"
+#include "userinterface/energymodel.h"
+#include "userinterface/appregistry.h"
+#include "userinterface/screenmanager.h"
+#include "userinterface/navigation.h"
+#include "userinterface/screentransition.h"
+#include "userinterface/styles/widgetstyle.h"
+#include "userinterface/screens/blepairing/blepairing.h"
+#include "watchdog/watchdog.h"
 #include "devicetwin/devicetwin.h"
+#include "datetime/timezone.h"
+#include "datetime/scheduler.h"
 
 LOG_MODULE_REGISTER(ZephyrWatch_UserInterface, LOG_LEVEL_INF);
 
-// Define the timer callbacks' prototypes.
-static void update_clock_view_callback(struct k_timer *timer);
-
 // Define the work queues' prototypes.
 static void clock_update_worker(struct k_work *work);
 static void date_day_update_worker(struct k_work *work);
 
+// Define the UI command handler's prototype.
+static void execute_ui_command(const ui_command_t *command);
+
+// Define the display event handler's prototype.
+static void display_event_callback(lv_event_t *event);
+
+// Define the input listener's prototype.
+static void input_listener_callback(struct input_event *event, void *user_data);
+
+// Define the idle mode's prototypes.
+static void enter_idle_mode();
+static void exit_idle_mode();
+
+// Define the display sleep's prototypes.
+static void sleep_display();
+static void wake_display();
+static void enter_ambient_mode();
+
+// Define the device twin listener's prototype.
+static void device_twin_listener_callback(const struct zbus_channel *chan);
+
+// Define the wall-clock events' prototypes.
+static void minute_tick_callback(wallclock_event_t *event);
+static void date_rollover_callback(wallclock_event_t *event);
+static void schedule_minute_tick(int64_t unix_time_ms);
+static void schedule_date_rollover(uint8_t timezone_id);
+
 static struct k_work_q ui_work_q;
 static K_THREAD_STACK_DEFINE(ui_stack_area, 4096);
 
@@ -29,13 +69,78 @@ static K_THREAD_STACK_DEFINE(ui_stack_area, 4096);
 static struct k_work clock_update_work;
 static struct k_work date_day_update_work;
 
-// Define timers.
-K_TIMER_DEFINE(clock_view_timer, update_clock_view_callback, NULL);
+// The device twin fields the home screen renders. Changes of the other fields are ignored.
+#define HOME_SCREEN_TWIN_FIELDS (DEVICE_TWIN_FIELD_UNIX_TIME | DEVICE_TWIN_FIELD_TIMEZONE)
+
+// Listen to the device twin changes.
+ZBUS_LISTENER_DEFINE(ui_device_twin_listener, device_twin_listener_callback);
+ZBUS_CHAN_ADD_OBS(device_twin_chan, ui_device_twin_listener, 0);
+
+// Wake the LVGL-owner thread up on input events, before LVGL reads them.
+INPUT_CALLBACK_DEFINE(NULL, input_listener_callback, NULL);
+
+/* LVGL's display refresh and input read timers run periodically, even if nothing is changed. After
+ * UI_IDLE_AFTER_MS without input, commands and animations, they are paused, and the owner thread
+ * sleeps until the next command or input event.
+ */
+#define UI_IDLE_AFTER_MS 1000
+static bool ui_idle = false;
+static bool ui_woken = false;
+static int64_t last_activity_ms = 0;
+
+/* The display goes to sleep after UI_DISPLAY_SLEEP_AFTER_MS without input, once the UI is idle. It
+ * wakes up with the next input event, or with a pairing request. The input event which wakes it up
+ * is not delivered to the widgets.
+ *
+ * On the home screen, the display does not blank but enters the ambient mode: the home screen shows
+ * only the clock at the minimum brightness, the refresh and input read timers stay paused, and the
+ * screen is refreshed once after the commands of each minute tick.
+ */
+#define UI_DISPLAY_SLEEP_AFTER_MS 15000
+#define UI_DISPLAY_FADE_OUT_MS 500
+#define UI_DISPLAY_FADE_IN_MS 150
+#define UI_AMBIENT_BRIGHTNESS 5
+static atomic_t input_pending = ATOMIC_INIT(0);
+static int64_t last_input_ms = 0;
+static bool ui_ambient = false;
+
+/* The LVGL heap the screens may use. The home screen is never evicted, and the menu and the pairing
+ * screens are kept hidden while they fit in the budget with it.
+ */
+#define UI_SCREEN_BUDGET_BYTES 8192
+
+/* The pixels flushed by LVGL. They are counted at each flush, and also summed for the current frame
+ * to log the traffic of each update. The bytes sent to the panel are counted by the round flush.
+ */
+static uint32_t flush_count = 0;
+static uint64_t flushed_pixel_count = 0;
+static uint32_t frame_pixel_count = 0;
+static uint32_t frame_start_cycles = 0;
+static uint64_t frame_start_sent_bytes = 0;
+
+// Wall-clock events for the next minute boundary and the next local midnight.
+static wallclock_event_t minute_tick_event;
+static wallclock_event_t date_rollover_event;
+
+// Local time shown on the screen and its changes not rendered yet. Only accessed from the UI
+// work queue.
+static datetime_cursor_t view_cursor;
+static uint8_t view_changes = 0;
+static uint8_t sync_view_cursor(int64_t unix_time_ms);
 
 /* USER_INTERFACE_INIT
- * Set-up LVGLs home screen.
+ * Set-up LVGLs home screen. The calling thread becomes the owner of LVGL.
  */
 void user_interface_init() {
+    // The other contexts post commands to the owner from now on.
+    ui_command_init();
+
+    // Register the applications listed in the menu.
+    register_application("settings", "Settings", NULL);
+    register_application("stopwatch", "Stopwatch", NULL);
+    register_application("weather", "Weather", NULL);
+    register_application("music", "Music", NULL);
+
     // Set-up LVGL stuff.
     lv_disp_t *display = lv_disp_get_default();
     lv_theme_t *theme = lv_theme_default_init(
@@ -46,8 +151,21 @@ void user_interface_init() {
         LV_FONT_DEFAULT
     );
     lv_disp_set_theme(display, theme);
-    home_screen_init();
-    lv_disp_load_scr(home_screen);
+    // The screens apply the shared styles instead of local ones.
+    widget_style_init();
+    // Only send the pixels inside the round panel's circle.
+    if (round_flush_attach(display) != 0) {
+        LOG_WRN("Round flush is not attached, the full areas are flushed.");
+    }
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(display, display_event_callback, LV_EVENT_REFR_READY, NULL);
+    screen_manager_init(UI_SCREEN_BUDGET_BYTES);
+    // Swipe up on the home screen to open the menu, and swipe down on the menu to go back.
+    navigation_bind_gesture(SCREEN_HOME, LV_DIR_TOP, SCREEN_MENU, LV_SCR_LOAD_ANIM_MOVE_TOP);
+    navigation_bind_gesture(SCREEN_MENU, LV_DIR_BOTTOM, SCREEN_NONE, LV_SCR_LOAD_ANIM_NONE);
+    screen_transition_init();
+    navigation_init(SCREEN_HOME);
 
     // Create a seperate the UI work queue.
     k_work_queue_start(&ui_work_q, ui_stack_area, K_THREAD_STACK_SIZEOF(ui_stack_area),
@@ -59,24 +177,97 @@ void user_interface_init() {
     k_work_init(&date_day_update_work, date_day_update_worker);
     LOG_DBG("The work items are set.");
 
-    // Start timers after work queue is ready - reduced frequency to prevent queue overflow.
-    k_timer_start(&clock_view_timer, K_MSEC(2000), K_SECONDS(10));
-    LOG_DBG("User interface timers are set.");
+    // Initialize the wall-clock events. They are scheduled by the workers.
+    wallclock_event_init(&minute_tick_event, minute_tick_callback, NULL);
+    wallclock_event_init(&date_rollover_event, date_rollover_callback, NULL);
+    LOG_DBG("The wall-clock events are set.");
 
+    k_work_submit_to_queue(&ui_work_q, &clock_update_work);
     k_work_submit_to_queue(&ui_work_q, &date_day_update_work);
     LOG_DBG("First update signal is send to clock updater.");
 }
 
 /* USER_INTERFACE_TASK_HANDLER
- * Call LVGLs task handler.
+ * Execute the posted UI commands, and call LVGLs task handler. It is only called by the LVGL-owner
+ * thread, and returns the milliseconds until LVGL needs to be called again. The owner sleeps until
+ * then, unless it is woken up with a command or an input event.
  */
-void user_interface_task_handler() {
-    lv_task_handler();
+uint32_t user_interface_task_handler() {
+    // The watchdog is only kicked while this loop runs.
+    watchdog_check_in();
+
+    if (atomic_clear(&input_pending)) {
+        last_input_ms = k_uptime_get();
+        if (is_display_asleep()) {
+            wake_display();
+        }
+    }
+
+    // Only a command or an input event ends the idle mode, the other LVGL timers do not. While the
+    // display sleeps, only an input event does.
+    if (ui_idle && ui_woken && !is_display_asleep()) {
+        exit_idle_mode();
+    }
+    ui_woken = false;
+    if (ui_command_drain(execute_ui_command) > 0) {
+        last_activity_ms = k_uptime_get();
+        // The paused refresh timer does not draw the changes in the ambient mode.
+        if (ui_ambient) {
+            lv_refr_now(NULL);
+        }
+    }
+
+    uint32_t next_call_ms = lv_timer_handler();
+
+    // Stop the periodic timers once nothing happens for a while.
+    bool inactive = !ui_idle && (k_uptime_get() - last_activity_ms >= UI_IDLE_AFTER_MS) &&
+                    (lv_display_get_inactive_time(NULL) >= UI_IDLE_AFTER_MS) &&
+                    (lv_anim_count_running() == 0);
+    if (inactive) {
+        // Build the screens the user may go to next, so their transitions start without building.
+        navigation_preload_neighbors();
+        enter_idle_mode();
+        next_call_ms = lv_timer_handler();
+    }
+
+    // Put the display to sleep once nothing is refreshed, and no input came for a while.
+    if (ui_idle && !is_display_asleep()) {
+        int64_t since_input_ms = k_uptime_get() - last_input_ms;
+        if (since_input_ms >= UI_DISPLAY_SLEEP_AFTER_MS && screen_manager_get_active() == SCREEN_HOME) {
+            enter_ambient_mode();
+        } else if (since_input_ms >= UI_DISPLAY_SLEEP_AFTER_MS) {
+            sleep_display();
+        } else {
+            next_call_ms = MIN(next_call_ms, (uint32_t)(UI_DISPLAY_SLEEP_AFTER_MS - since_input_ms));
+        }
+    }
+    return next_call_ms;
+}
+
+/* USER_INTERFACE_WAIT
+ * Sleep the LVGL-owner thread for the given milliseconds, or until a command or
+ * an input event arrives. LV_NO_TIMER_READY sleeps until then. It wakes up at least
+ * once in the watchdog's check-in period.
+ */
+void user_interface_wait(uint32_t timeout_ms) {
+    k_timeout_t timeout = K_MSEC(MIN(timeout_ms, WATCHDOG_CHECK_IN_PERIOD_MS));
+    if (ui_command_wait(timeout) == 0) {
+        ui_woken = true;
+    }
+}
+
+/* USER_INTERFACE_GET_FLUSH_STATS
+ * Return the number of the flushes and the pixels pushed to the display.
+ */
+void user_interface_get_flush_stats(uint32_t *flushes, uint64_t *pixels) {
+    *flushes = flush_count;
+    *pixels = flushed_pixel_count;
 }
 
 /* TRIGGER_UI_CHANGE
- * Function to update the UI from external sources (like Bluetooth CTS).
- * This function will be called by the external sources.
+ * Function to update the clock and date views from scratch. It is called when
+ * the device twin's time or time zone is changed (e.g. by Bluetooth CTS). The
+ * workers re-arm the wall-clock events relative to the new time.
  */
 void trigger_ui_update() {
     // Only submit if not already pending.
@@ -88,60 +279,299 @@ void trigger_ui_update() {
     }
 }
 
-/* UPDATE_CLOCK_VIEW_CALLBACK
- * This function is called by the timer to update the clock view.
+/* DISPLAY_EVENT_CALLBACK
+ * This function is called by LVGL at the start of each refresh, before each
+ * flush with the flushed area, and after each refresh. It counts the pixels
+ * pushed to the display, and measures the render time of the frame. The end
+ * of a refresh also ends the latency of the commands it draws.
+ */
+static void display_event_callback(lv_event_t *event) {
+    lv_event_code_t event_code = lv_event_get_code(event);
+
+    if (event_code == LV_EVENT_REFR_START) {
+        round_flush_stats_t stats;
+        round_flush_get_stats(&stats);
+        frame_start_sent_bytes = stats.sent_bytes;
+        frame_start_cycles = k_cycle_get_32();
+    } else if (event_code == LV_EVENT_FLUSH_START) {
+        const lv_area_t *area = lv_event_get_param(event);
+        uint32_t pixels = lv_area_get_size(area);
+        flush_count++;
+        flushed_pixel_count += pixels;
+        frame_pixel_count += pixels;
+    } else {
+        ui_command_frame_ready();
+        if (frame_pixel_count == 0) {
+            return;
+        }
+        round_flush_stats_t stats;
+        round_flush_get_stats(&stats);
+        LOG_DBG("Frame flushed %u pixels, sent %u bytes in %u us.", frame_pixel_count,
+                (uint32_t)(stats.sent_bytes - frame_start_sent_bytes),
+                k_cyc_to_us_floor32(k_cycle_get_32() - frame_start_cycles));
+        energy_model_count_frame(frame_pixel_count);
+        frame_pixel_count = 0;
+    }
+}
+
+/* INPUT_LISTENER_CALLBACK
+ * This function is called by the input subsystem for each input event. It runs
+ * in the input thread, so it only wakes the LVGL-owner thread up to read it.
+ */
+static void input_listener_callback(struct input_event *event, void *user_data) {
+    atomic_set(&input_pending, 1);
+    ui_command_wake();
+}
+
+/* ENTER_IDLE_MODE
+ * Pause the display refresh and input read timers. The last refresh is done
+ * already, since they are paused only a while after the last change.
+ */
+static void enter_idle_mode() {
+    lv_timer_pause(lv_display_get_refr_timer(lv_display_get_default()));
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        lv_timer_pause(lv_indev_get_read_timer(indev));
+    }
+    ui_idle = true;
+    LOG_DBG("User interface is idle.");
+}
+
+/* EXIT_IDLE_MODE
+ * Resume the display refresh and input read timers, and run them right away
+ * to read the input which woke the owner thread up.
+ */
+static void exit_idle_mode() {
+    lv_timer_t *refresh_timer = lv_display_get_refr_timer(lv_display_get_default());
+    lv_timer_resume(refresh_timer);
+    lv_timer_ready(refresh_timer);
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        lv_timer_t *read_timer = lv_indev_get_read_timer(indev);
+        lv_timer_resume(read_timer);
+        lv_timer_ready(read_timer);
+    }
+    ui_idle = false;
+    last_activity_ms = k_uptime_get();
+    LOG_DBG("User interface is active.");
+}
+
+/* SLEEP_DISPLAY
+ * Fade the display out and blank it. The refresh timer is paused already, so only the flush of the
+ * last frame may still be running.
+ */
+static void sleep_display() {
+    round_flush_wait();
+    int ret = display_sleep(UI_DISPLAY_FADE_OUT_MS);
+    if (ret != 0) {
+        LOG_ERR("Failed to put the display to sleep.");
+    }
+    energy_model_set_mode(ENERGY_MODE_SLEEP);
+}
+
+/* ENTER_AMBIENT_MODE
+ * Draw the ambient layout of the home screen once, and dim the display. The refresh and input read
+ * timers are paused already.
+ */
+static void enter_ambient_mode() {
+    energy_model_set_mode(ENERGY_MODE_AMBIENT);
+    home_screen_set_ambient(true);
+    lv_refr_now(NULL);
+    int ret = display_dim(UI_AMBIENT_BRIGHTNESS, UI_DISPLAY_FADE_OUT_MS);
+    if (ret != 0) {
+        LOG_ERR("Failed to dim the display.");
+    }
+    ui_ambient = true;
+    LOG_DBG("User interface is in the ambient mode.");
+}
+
+/* WAKE_DISPLAY
+ * Turn the display on, leave the ambient mode, and resume the refresh. The widgets ignore the
+ * current press until it is released, so the touch which wakes the display up does not click
+ * anything.
+ */
+static void wake_display() {
+    if (ui_ambient) {
+        home_screen_set_ambient(false);
+        ui_ambient = false;
+    }
+    energy_model_set_mode(ENERGY_MODE_NORMAL);
+
+    int ret = display_wake(UI_DISPLAY_FADE_IN_MS);
+    if (ret != 0) {
+        LOG_ERR("Failed to wake the display up.");
+    }
+    if (ui_idle) {
+        exit_idle_mode();
+    }
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        lv_indev_wait_release(indev);
+    }
+}
+
+/* DEVICE_TWIN_LISTENER_CALLBACK
+ * This function is called by zbus when the device twin is changed. It runs in
+ * the publisher's context, so it only submits the workers of the affected views.
+ */
+static void device_twin_listener_callback(const struct zbus_channel *chan) {
+    const device_twin_event_t *event = zbus_chan_const_msg(chan);
+    LOG_DBG("Device twin fields changed: 0x%08x", event->changed_fields);
+
+    if (event->changed_fields & HOME_SCREEN_TWIN_FIELDS) {
+        trigger_ui_update();
+    }
+}
+
+/* EXECUTE_UI_COMMAND
+ * This function is called by the LVGL-owner thread for each posted UI command.
+ * It is the only place the views are modified from outside of LVGL's own events.
+ */
+static void execute_ui_command(const ui_command_t *command) {
+    uint8_t ret = 0;
+
+    switch (command->type) {
+    case UI_COMMAND_SET_CLOCK:
+        ret = home_screen_set_clock(command->clock.hour, command->clock.minute);
+
+        uint32_t update_count, redundant_update_count, changed_cell_count;
+        home_screen_get_clock_stats(&update_count, &redundant_update_count, &changed_cell_count);
+        LOG_DBG("Clock view updates: %u, redundant: %u, redrawn digits: %u.", update_count,
+                redundant_update_count, changed_cell_count);
+        break;
+    case UI_COMMAND_SET_DATE:
+        ret = home_screen_set_date(command->date.year, command->date.month, command->date.day);
+        break;
+    case UI_COMMAND_SET_DAY:
+        ret = home_screen_set_day(command->day.weekday);
+        break;
+    case UI_COMMAND_SHOW_PAIRING:
+        // The PIN has to be seen, so the display wakes up as if it was touched.
+        last_input_ms = k_uptime_get();
+        if (is_display_asleep()) {
+            wake_display();
+        }
+        // The pairing screen is only created if it does not exist, e.g. it was evicted.
+        screen_manager_get(SCREEN_BLEPAIRING);
+        ret = blepairing_screen_set_pin(command->pairing.pin);
+        blepairing_screen_load();
+        break;
+    case UI_COMMAND_HIDE_PAIRING:
+        blepairing_screen_unload();
+        break;
+    }
+
+    if (ret != 0) {
+        LOG_ERR("Failed to execute UI command %d.", command->type);
+    }
+}
+
+/* MINUTE_TICK_CALLBACK
+ * This function is called by the wall-clock scheduler at each minute boundary.
  * It sends an event to the UI work queue to update the clock view.
  */
-static void update_clock_view_callback(struct k_timer *timer) {
+static void minute_tick_callback(wallclock_event_t *event) {
     LOG_DBG("Pushing clock_update_work work to ui_work_q.");
     k_work_submit_to_queue(&ui_work_q, &clock_update_work);
 }
 
+/* DATE_ROLLOVER_CALLBACK
+ * This function is called by the wall-clock scheduler at local midnight.
+ * It sends an event to the UI work queue to update the date and day views.
+ */
+static void date_rollover_callback(wallclock_event_t *event) {
+    LOG_DBG("Pushing date_day_update_work work to ui_work_q.");
+    k_work_submit_to_queue(&ui_work_q, &date_day_update_work);
+}
+
 /* CLOCK_UPDATE_WORKER
  * This function is called by the UI work queue to update the clock view.
- * It updates the current time in the device twin and then
- * calls the home screen set clock function.
+ * It moves the view cursor to the device twin's current time, updates the
+ * clock view only if the minute is changed, and schedules itself for the
+ * next minute boundary.
  */
 static void clock_update_worker(struct k_work *work) {
-    // Get the device twin to use the latest information..
-    device_twin_t* device_twin = get_device_twin_instance();
-    LOG_DBG("Device's clock in UNIX epochs: %u", device_twin->unix_time);
+    int64_t unix_time_ms = get_current_unix_time_ms();
 
-    // Construct the local time from UNIX time and save it.
-    datetime_t local_time = unix_to_localtime(device_twin->unix_time, device_twin->utc_zone);
+    // Move the local time to the device twin's time.
+    uint8_t changed = sync_view_cursor(unix_time_ms);
+    datetime_t *local_time = &view_cursor.local;
 
-    // Update the clock view using the device twin's current time.
-    uint8_t ret = home_screen_set_clock(local_time.hour, local_time.minute);
-    if (ret != 0) {
-        LOG_ERR("Failed to update the clock view.");
+    // Update the clock view only if the displayed fields are changed.
+    if (changed & (DATETIME_CHANGED_MINUTE | DATETIME_CHANGED_HOUR)) {
+        int ret = ui_command_post_set_clock(local_time->hour, local_time->minute);
+        if (ret != 0) {
+            LOG_ERR("Failed to post the clock view update.");
+        }
     }
+    view_changes &= ~(DATETIME_CHANGED_SECOND | DATETIME_CHANGED_MINUTE | DATETIME_CHANGED_HOUR);
 
-    // Send a date day update worker if 00:00.
-    if (local_time.hour == 0 && local_time.minute == 0) {
-        k_work_submit_to_queue(&ui_work_q, &date_day_update_work);
-        LOG_DBG("Date and day update worker submitted to queue.");
-    }
+    schedule_minute_tick(unix_time_ms);
 }
 
 /* DATE_DAY_UPDATE_WORKER
  * This function is called by the UI work queue to update the date and day view.
- * It updates the current time in the device twin and then
- * calls the home screen set date function.
+ * It moves the view cursor to the device twin's current time, calls the home
+ * screen set date function, and schedules itself for the next local midnight.
  */
 static void date_day_update_worker(struct k_work *work) {
-    // Get the device twin to find UTC zone.
-    device_twin_t* device_twin = get_device_twin_instance();
-
-    // Construct the local time from UNIX time and save it.
-    datetime_t local_time = unix_to_localtime(device_twin->unix_time, device_twin->utc_zone);
+    // Move the local time to the device twin's time.
+    sync_view_cursor(get_current_unix_time_ms());
+    datetime_t *local_time = &view_cursor.local;
 
     // Update the date and day views using the device twin's current time.
-    uint8_t ret = home_screen_set_date(local_time.year, local_time.month, local_time.day);
+    int ret = ui_command_post_set_date(local_time->year, local_time->month, local_time->day);
     if (ret != 0) {
-        LOG_ERR("Failed to update the date view.");
+        LOG_ERR("Failed to post the date view update.");
     }
-    ret = home_screen_set_day(local_time.weekday);
+    ret = ui_command_post_set_day(local_time->weekday);
     if (ret != 0) {
-        LOG_ERR("Failed to update the day view.");
+        LOG_ERR("Failed to post the day view update.");
     }
-}
\ No newline at end of file
+    view_changes &= ~DATETIME_CHANGED_DAY;
+
+    device_twin_t device_twin;
+    device_twin_snapshot(&device_twin);
+    schedule_date_rollover(device_twin.timezone_id);
+}
+
+/* SCHEDULE_MINUTE_TICK
+ * Schedule the minute tick event for the minute boundary after the given time. UTC offsets are
+ * whole minutes, so the local and UTC minute boundaries are the same.
+ */
+static void schedule_minute_tick(int64_t unix_time_ms) {
+    int64_t next_minute_ms = (unix_time_ms / (60 * MSEC_PER_SEC) + 1) * (60 * MSEC_PER_SEC);
+
+    int ret = wallclock_schedule(&minute_tick_event, next_minute_ms);
+    if (ret != 0) {
+        LOG_ERR("Failed to schedule the minute tick.");
+    }
+}
+
+/* SCHEDULE_DATE_ROLLOVER
+ * Schedule the date rollover event for the next local midnight of the view cursor. If the UTC
+ * offset changes before midnight, the event is scheduled for the change to compute it again.
+ */
+static void schedule_date_rollover(uint8_t timezone_id) {
+    datetime_t *local_time = &view_cursor.local;
+    int64_t seconds_into_day = local_time->hour * 3600 + local_time->minute * 60 + local_time->second;
+    int64_t next_midnight = view_cursor.unix_time - seconds_into_day + 86400;
+    int64_t next_transition = timezone_get_next_transition(timezone_id, view_cursor.unix_time);
+
+    int ret = wallclock_schedule(&date_rollover_event, MIN(next_midnight, next_transition) * MSEC_PER_SEC);
+    if (ret != 0) {
+        LOG_ERR("Failed to schedule the date rollover.");
+    }
+}
+
+/* SYNC_VIEW_CURSOR
+ * Move the view cursor to the device twin's current time. It returns the changes which are not
+ * rendered yet, since each worker clears only the changes of the views it updates.
+ */
+static uint8_t sync_view_cursor(int64_t unix_time_ms) {
+    device_twin_t device_twin;
+    device_twin_snapshot(&device_twin);
+    int64_t unix_time = unix_time_ms / MSEC_PER_SEC;
+    LOG_DBG("Device's clock in UNIX epochs: %lld", unix_time);
+
+    int16_t utc_offset_minutes = timezone_get_offset_minutes(device_twin.timezone_id, unix_time);
+    view_changes |= datetime_cursor_sync(&view_cursor, unix_time, utc_offset_minutes);
+    return view_changes;
+}
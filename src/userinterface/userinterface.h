@@ -18,8 +18,16 @@ extern "C" {
 /* Initilize the user interface. */
 void user_interface_init();
 
-/* Refresh/process the user interface jobs. */
-void user_interface_task_handler();
+/* Refresh/process the user interface jobs. Returns the milliseconds until the next call is due. */
+uint32_t user_interface_task_handler();
+
+/* Sleep until the next call is due, or a command or an input event arrives, at most the watchdog's
+ * check-in period.
+ */
+void user_interface_wait(uint32_t timeout_ms);
+
+/* Get the number of the flushes and the pixels pushed to the display since boot. */
+void user_interface_get_flush_stats(uint32_t *flushes, uint64_t *pixels);
 
 /* Trigger an UI update. It is useful to update clock with external source. */
 void trigger_ui_update();
@@ -7,6 +7,12 @@
  */
 
 #include "lvgl.h"
+#include <zephyr/logging/log.h>
+
+#include "userinterface/styles/widgetstyle.h"
+
+// Create a logger.
+LOG_MODULE_REGISTER(ZephyrWatch_UI_Utils, LOG_LEVEL_INF);
 
 void remove_scrollable(lv_obj_t *obj) {
     // Remove the ability to scroll the object.
@@ -33,21 +39,12 @@ lv_obj_t* create_column(lv_obj_t* root, uint8_t width_perc, uint8_t height_perc)
     lv_obj_set_size(column, LV_PCT(width_perc), LV_PCT(height_perc));
     lv_obj_center(column);
 
-    // Set the layout.
-    lv_obj_set_layout(column, LV_LAYOUT_FLEX);
-    lv_obj_set_flex_flow(column, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(column,
-                          LV_FLEX_ALIGN_CENTER,  // Main axis (vertical)
-                          LV_FLEX_ALIGN_CENTER,  // Cross axis (horizontal)
-                          LV_FLEX_ALIGN_CENTER); // Track alignment
-    
+    // Set the centered flex layout without borders and background from the shared style.
+    lv_obj_add_style(column, get_widget_style_flex_column(), LV_PART_MAIN);
+
     // Remove scrolling and set it to off.
     remove_scrollable(column);
 
-    // Remove the borders.
-    lv_obj_set_style_border_width(column, 0, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(column, LV_OPA_TRANSP, LV_PART_MAIN);
-
     // Return the column instance.
     return column;
 }
@@ -62,21 +59,25 @@ lv_obj_t* create_row(lv_obj_t* root, uint8_t width_perc, uint8_t height_perc) {
     lv_obj_set_size(row, LV_PCT(width_perc), LV_PCT(height_perc));
     lv_obj_center(row);
 
-    // Use flext layout on the row.
-    lv_obj_set_layout(row, LV_LAYOUT_FLEX);
-    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(row,
-                          LV_FLEX_ALIGN_CENTER,  // Main axis (vertical)
-                          LV_FLEX_ALIGN_CENTER,  // Cross axis (horizontal)
-                          LV_FLEX_ALIGN_CENTER); // Track alignment
+    // Set the centered flex layout without borders and background from the shared style.
+    lv_obj_add_style(row, get_widget_style_flex_row(), LV_PART_MAIN);
 
     // Remove scrolling and set it to off.
     remove_scrollable(row);
 
-    // Remove the borders.
-    lv_obj_set_style_border_width(row, 0, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(row, LV_OPA_TRANSP, LV_PART_MAIN);
-
     // Return the created row object.
     return row;
-}
\ No newline at end of file
+}
+
+uint32_t get_heap_used() {
+    // Measure the used part of the LVGL heap.
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+    return monitor.total_size - monitor.free_size;
+}
+
+void log_screen_heap_usage(const char *screen_name, uint32_t heap_used_before) {
+    uint32_t heap_used = get_heap_used();
+    LOG_INF("%s screen uses %d bytes of the LVGL heap, %u bytes are used in total.", screen_name,
+            (int32_t)(heap_used - heap_used_before), heap_used);
+}
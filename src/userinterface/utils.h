@@ -15,6 +15,12 @@ extern "C" {
 
 #include "lvgl.h"
 
+/**
+ * Remove the scrolling and the scrollbar of the object.
+ * @param obj The lv_obj_t instance to be made non-scrollable.
+ */
+void remove_scrollable(lv_obj_t *obj);
+
 /**
  * Create a new screen object with no parent and scrolling.
  * @return The created lv_obj_t screen instance.
@@ -39,6 +45,19 @@ lv_obj_t* create_column(lv_obj_t* root, uint8_t width_perc, uint8_t height_perc)
  */
 lv_obj_t* create_row(lv_obj_t* root, uint8_t width_perc, uint8_t height_perc);
 
+/**
+ * Get the used bytes of the LVGL heap.
+ * @return The total size of the heap minus its free bytes.
+ */
+uint32_t get_heap_used();
+
+/**
+ * Log the LVGL heap used by a screen, e.g. at the end of its init function.
+ * @param screen_name The name of the screen to log.
+ * @param heap_used_before The used bytes of the LVGL heap before the screen is created.
+ */
+void log_screen_heap_usage(const char *screen_name, uint32_t heap_used_before);
+
 
 #ifdef __cplusplus
 }
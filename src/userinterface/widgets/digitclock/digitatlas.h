@@ -0,0 +1,29 @@
+/** Clock Digit Atlas.
+ * Pre-rendered RGB565 images of the clock glyphs, generated at build time by
+ * scripts/generate_digit_atlas.py from the Montserrat 46 font of LVGL.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _UI_WIDGETS_DIGITATLAS_H
+#define _UI_WIDGETS_DIGITATLAS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+// The glyphs are '0' to '9' at their digit index, and ':' after them.
+#define DIGIT_ATLAS_GLYPH_COUNT 11
+#define DIGIT_ATLAS_COLON 10
+
+/* The glyph images. The digits share the same size, and all of them are rendered on black. */
+extern const lv_image_dsc_t digit_atlas[DIGIT_ATLAS_GLYPH_COUNT];
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
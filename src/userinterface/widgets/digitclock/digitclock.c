@@ -0,0 +1,56 @@
+/** Digit Clock Widget implementation.
+ * The clock is a flex row of images, one for each character of "HH:MM", showing the glyphs of the
+ * digit atlas. The images are opaque RGB565 in the display's format, so drawing a cell is a plain
+ * copy to the draw buffer. Since the cells never change their size, rewriting a cell does not move
+ * the others, and LVGL only redraws the area of that cell.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include "lvgl.h"
+#include "userinterface/utils.h"
+#include "userinterface/styles/widgetstyle.h"
+#include "userinterface/widgets/digitclock/digitclock.h"
+#include "userinterface/widgets/digitclock/digitatlas.h"
+
+// The characters of "HH:MM" and the space between them.
+#define DIGIT_CLOCK_CELL_COUNT 5
+#define DIGIT_CLOCK_CELL_SPACING 5
+
+// The glyphs shown until the first time is set.
+static const uint8_t initial_glyphs[DIGIT_CLOCK_CELL_COUNT] = { 0, 0, DIGIT_ATLAS_COLON, 0, 0 };
+
+lv_obj_t* digit_clock_create(lv_obj_t *parent) {
+    // Create a row that only takes the size of its cells.
+    lv_obj_t *clock = lv_obj_create(parent);
+    lv_obj_set_size(clock, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_add_style(clock, get_widget_style_flex_row(), LV_PART_MAIN);
+    lv_obj_add_style(clock, get_widget_style_no_border(), LV_PART_MAIN);
+    lv_obj_set_style_pad_column(clock, DIGIT_CLOCK_CELL_SPACING, LV_PART_MAIN);
+    remove_scrollable(clock);
+
+    // The cells take the size of their images, which is the same for all digits.
+    for (uint8_t i = 0; i < DIGIT_CLOCK_CELL_COUNT; i++) {
+        lv_obj_t *cell = lv_image_create(clock);
+        lv_image_set_src(cell, &digit_atlas[initial_glyphs[i]]);
+    }
+    return clock;
+}
+
+uint8_t digit_clock_set_time(lv_obj_t *clock, uint8_t hour, uint8_t minute) {
+    const uint8_t glyphs[DIGIT_CLOCK_CELL_COUNT] = {
+        hour / 10, hour % 10, DIGIT_ATLAS_COLON, minute / 10, minute % 10
+    };
+
+    // Rewrite only the cells showing a different glyph.
+    uint8_t changed_cells = 0;
+    for (uint8_t i = 0; i < DIGIT_CLOCK_CELL_COUNT; i++) {
+        lv_obj_t *cell = lv_obj_get_child(clock, i);
+        if (lv_image_get_src(cell) != &digit_atlas[glyphs[i]]) {
+            lv_image_set_src(cell, &digit_atlas[glyphs[i]]);
+            changed_cells++;
+        }
+    }
+    return changed_cells;
+}
@@ -0,0 +1,37 @@
+/** Digit Clock Widget.
+ * Shows the "HH:MM" time with a cell per character, so that a time change only invalidates the
+ * cells of the changed digits instead of the whole label. The cells are blitted from the
+ * pre-rendered digit atlas instead of being rasterized from a font.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#ifndef _UI_WIDGETS_DIGITCLOCK_H
+#define _UI_WIDGETS_DIGITCLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+/** Create a digit clock in the parent. It must be placed on a black background.
+ * @param parent The parent object of the clock.
+ * @return The created clock object.
+ */
+lv_obj_t* digit_clock_create(lv_obj_t *parent);
+
+/** Show the time on the clock. Only the changed cells are rewritten.
+ * @param clock The clock object created with digit_clock_create().
+ * @param hour The hour in 24-hour format.
+ * @param minute The minute.
+ * @return The number of the changed cells.
+ */
+uint8_t digit_clock_set_time(lv_obj_t *clock, uint8_t hour, uint8_t minute);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -4,6 +4,8 @@
  * @license GNU v3
  * @maintainer electricalgorithm @ github
  */
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -18,10 +20,26 @@ LOG_MODULE_REGISTER(ZephyrWatch_Watchdog, LOG_LEVEL_INF);
 #define WATCHDOG_DEVICE DT_ALIAS(watchdogdevice)
 #define WATCHDOG_TIMEOUT_MS 30000
 
+/* The watchdog is kicked from the system work queue with this period, only if the UI loop checked in
+ * since the previous kick. The loop checks in every WATCHDOG_CHECK_IN_PERIOD_MS at least, so a kick
+ * without a check-in means the loop is stuck.
+ */
+#define WATCHDOG_KICK_PERIOD_MS 10000
+
+BUILD_ASSERT(WATCHDOG_CHECK_IN_PERIOD_MS < WATCHDOG_KICK_PERIOD_MS,
+             "The UI loop must check in between each two kicks.");
+
 // Store the variables for kicking it.
 static const struct device *watchdog_device = DEVICE_DT_GET(WATCHDOG_DEVICE);
 static int channel_id;
 
+// Set by the UI loop, and cleared by each kick. It starts set for the first kick during the boot.
+static atomic_t ui_checked_in = ATOMIC_INIT(1);
+
+// Prototype definition of internal static functions.
+static void kick_worker(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(kick_work, kick_worker);
+
 /* ENABLE_WATCHDOG_SUBSYSTEM
  * Prepare the watchdog device in the system. Call it before all the subsystems.
  */
@@ -64,6 +82,10 @@ int enable_watchdog_subsystem() {
     }
     LOG_DBG("Watchdog set-up is completed.");
 
+    // Start kicking it periodically.
+    k_work_schedule(&kick_work, K_MSEC(WATCHDOG_KICK_PERIOD_MS));
+    LOG_DBG("Watchdog kicking is scheduled.");
+
     return ret;
 }
 
@@ -71,6 +93,7 @@ int enable_watchdog_subsystem() {
  * Deregister all watchdog timeouts and remove the subsystem.
  */
 int disable_watchdog_subsystem() {
+    k_work_cancel_delayable(&kick_work);
     int ret = wdt_disable(watchdog_device);
     if (ret) LOG_ERR("Could not disable watchdog timers. (RET: %d)", ret);
     return ret;
@@ -84,4 +107,28 @@ void kick_watchdog() {
     if (ret) {
         LOG_ERR("Couldn't kick watchdog timer. (RET: %d)", ret);
     }
-}
\ No newline at end of file
+}
+
+/* WATCHDOG_CHECK_IN
+ * Mark the UI loop as running until the next kick.
+ */
+void watchdog_check_in() {
+    atomic_set(&ui_checked_in, 1);
+}
+
+/** **************** **/
+/** STATIC FUNCTIONS **/
+/** **************** **/
+
+/* KICK_WORKER
+ * Kick the watchdog if the UI loop checked in since the previous kick, and schedule the next kick.
+ * It runs on the system work queue, so a stuck work queue or a stuck UI loop resets the device.
+ */
+static void kick_worker(struct k_work *work) {
+    if (atomic_clear(&ui_checked_in)) {
+        kick_watchdog();
+    } else {
+        LOG_WRN("UI loop did not check in for %u ms.", WATCHDOG_KICK_PERIOD_MS);
+    }
+    k_work_schedule(&kick_work, K_MSEC(WATCHDOG_KICK_PERIOD_MS));
+}
@@ -12,7 +12,14 @@
 extern "C" {
 #endif
 
-/* Initialize the watchdog subsystem. */
+/* The UI loop checks in at least this often. It is shorter than the kick period, so a running loop is
+ * seen by every kick.
+ */
+#define WATCHDOG_CHECK_IN_PERIOD_MS 5000
+
+/* Initialize the watchdog subsystem. It is kicked periodically from then on, while the UI loop
+ * checks in.
+ */
 int enable_watchdog_subsystem();
 
 /* Deregister the watchdog timers. */
@@ -21,6 +28,9 @@ int disable_watchdog_subsystem();
 /* Kick the watchdog. */
 void kick_watchdog();
 
+/* Tell the watchdog that the UI loop is running. It is called from the LVGL-owner thread. */
+void watchdog_check_in();
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,205 @@
+/** Tests of the civil calendar conversion.
+ * unix_to_localtime() is checked against the C library's gmtime_r() over the whole 32-bit range of
+ * the UNIX time, and its cost per call is compared with the year-by-year walk it replaced.
+ *
+ * The benchmark is timed with the benchmark clock, which reads the host's clock on native_sim.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <time.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "benchmark/benchmarkclock.h"
+#include "datetime/datetime.h"
+#include "datetime/scheduler.h"
+#include "datetime/timezone.h"
+
+// A prime step, so the checked times fall on all the seconds, minutes and hours of the day.
+#define GMTIME_STEP_SECONDS 3607
+
+// The fastest of the rounds counts, so an interrupt or a preempting host process does not.
+#define BENCHMARK_CALLS 10000
+#define BENCHMARK_ROUNDS 5
+
+// The conversion must cost the same in 2037 as in 1971, with this much slack for the caches.
+#define BENCHMARK_MAX_GROWTH_PERCENT 25
+
+#define SECONDS_PER_DAY 86400
+
+static volatile uint32_t benchmark_sink;
+
+/* The conversions do not use the time zones and the scheduler of the datetime subsystem. */
+void wallclock_reschedule() {
+}
+
+int16_t timezone_get_offset_minutes(uint8_t timezone_id, int64_t unix_time) {
+    return 0;
+}
+
+/* CHECK_AGAINST_GMTIME
+ * Compare the conversion of the UNIX time with the C library's, if the library's time_t holds it.
+ */
+static void check_against_gmtime(int64_t timestamp) {
+    time_t host_time = (time_t)timestamp;
+    if ((int64_t)host_time != timestamp) {
+        return;
+    }
+    struct tm expected;
+    zassert_not_null(gmtime_r(&host_time, &expected));
+
+    datetime_t actual = unix_to_localtime(timestamp, 0);
+    bool equal = actual.year == expected.tm_year + 1900 && actual.month == expected.tm_mon + 1 &&
+                 actual.day == expected.tm_mday && actual.hour == expected.tm_hour &&
+                 actual.minute == expected.tm_min && actual.second == expected.tm_sec &&
+                 actual.weekday == expected.tm_wday;
+    zassert_true(equal, "%lld is %04u-%02u-%02u %02u:%02u:%02u (weekday %u), expected %04d-%02d-%02d.",
+                 (long long)timestamp, actual.year, actual.month, actual.day, actual.hour, actual.minute,
+                 actual.second, actual.weekday, expected.tm_year + 1900, expected.tm_mon + 1,
+                 expected.tm_mday);
+}
+
+/* WALK_DAYS_TO_DATE
+ * The conversion before the constant-time one: walk the years from 1970, then the months. It only
+ * supports the times after 1970, and returns the date as YYYYMMDD.
+ */
+static uint32_t walk_days_to_date(uint32_t days) {
+    static const uint8_t days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    uint16_t year = 1970;
+    while (true) {
+        bool leap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+        uint16_t days_in_year = leap ? 366 : 365;
+        if (days < days_in_year) break;
+        days -= days_in_year;
+        year++;
+    }
+
+    bool leap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+    uint8_t month = 0;
+    while (true) {
+        uint8_t days_of_month = days_in_month[month] + (month == 1 && leap);
+        if (days < days_of_month) break;
+        days -= days_of_month;
+        month++;
+    }
+    return year * 10000 + (month + 1) * 100 + days + 1;
+}
+
+/* CONVERT_CONSTANT_TIME
+ * The constant-time conversion, with the day as the result.
+ */
+static uint32_t convert_constant_time(int64_t timestamp) {
+    return unix_to_localtime(timestamp, 0).day;
+}
+
+/* CONVERT_WALK
+ * The year walk, with the date as the result.
+ */
+static uint32_t convert_walk(int64_t timestamp) {
+    return walk_days_to_date((uint32_t)timestamp / SECONDS_PER_DAY);
+}
+
+/* MEASURE_NS_PER_CALL
+ * Return the nanoseconds per call of the conversion from the given time on, three hours apart, in
+ * the fastest round.
+ */
+static uint32_t measure_ns_per_call(uint32_t (*convert)(int64_t), int64_t start) {
+    uint64_t fastest_round_ns = UINT64_MAX;
+    for (uint32_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+        benchmark_clock_t round_start = benchmark_clock_start();
+        for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+            benchmark_sink += convert(start + (int64_t)i * SECONDS_PER_DAY / 8);
+        }
+        fastest_round_ns = MIN(fastest_round_ns, benchmark_clock_elapsed_ns(round_start));
+    }
+    return fastest_round_ns / BENCHMARK_CALLS;
+}
+
+ZTEST(calendar, test_matches_gmtime_in_32_bit_range) {
+    for (int64_t timestamp = INT32_MIN; timestamp <= INT32_MAX; timestamp += GMTIME_STEP_SECONDS) {
+        check_against_gmtime(timestamp);
+    }
+    check_against_gmtime(INT32_MAX);
+    check_against_gmtime(0);
+    check_against_gmtime(-1);
+}
+
+ZTEST(calendar, test_matches_gmtime_at_leap_days) {
+    // 1904 and 2000 are leap years, 1900 and 2100 are not.
+    static const int64_t leap_days[] = {
+        -2203977600,  // 1900-02-28
+        -2077747200,  // 1904-02-29
+        951782400,    // 2000-02-29
+        4107456000,   // 2100-02-28
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(leap_days); i++) {
+        for (int64_t seconds = -SECONDS_PER_DAY; seconds < 2 * SECONDS_PER_DAY; seconds += 3600) {
+            check_against_gmtime(leap_days[i] + seconds);
+        }
+    }
+}
+
+ZTEST(calendar, test_local_time_applies_the_offset) {
+    // 2025-01-01 00:30:00 UTC is still 2024 in New York, and 06:00 in Kolkata.
+    datetime_t new_york = unix_to_localtime(1735691400, -300);
+    zassert_equal(new_york.year, 2024);
+    zassert_equal(new_york.month, 12);
+    zassert_equal(new_york.day, 31);
+    zassert_equal(new_york.hour, 19);
+
+    datetime_t kolkata = unix_to_localtime(1735691400, 330);
+    zassert_equal(kolkata.day, 1);
+    zassert_equal(kolkata.hour, 6);
+    zassert_equal(kolkata.minute, 0);
+}
+
+ZTEST(calendar, test_cursor_matches_conversion) {
+    // Walk over the end of the leap day of 2024 and the year change, in uneven steps.
+    datetime_cursor_t cursor = { .valid = false };
+    int64_t timestamp = 1709164800;  // 2024-02-29 00:00:00 UTC
+    datetime_cursor_reset(&cursor, timestamp, 60);
+
+    while (timestamp < 1735776000) {  // 2025-01-02 00:00:00 UTC
+        uint32_t step = 1 + (uint32_t)(timestamp % 3599);
+        timestamp += step;
+        datetime_cursor_advance(&cursor, step);
+
+        datetime_t expected = unix_to_localtime(timestamp, 60);
+        zassert_mem_equal(&cursor.local, &expected, sizeof(expected), "Cursor is off at %lld.",
+                          (long long)timestamp);
+    }
+}
+
+ZTEST(calendar, test_invalid_cursor_is_not_advanced) {
+    datetime_cursor_t cursor = { .valid = false };
+    zassert_equal(datetime_cursor_advance(&cursor, 1), 0);
+    zassert_equal(datetime_cursor_advance(&cursor, 2 * SECONDS_PER_DAY), 0);
+    zassert_false(cursor.valid);
+
+    // A reset makes it valid.
+    zassert_equal(datetime_cursor_reset(&cursor, 1735689600, 0), DATETIME_CHANGED_ALL);
+    zassert_equal(datetime_cursor_advance(&cursor, 1), DATETIME_CHANGED_SECOND);
+}
+
+ZTEST(calendar, test_benchmark_ns_per_call) {
+    // 1971-01-01 and 2037-01-01.
+    const int64_t early = 31536000;
+    const int64_t late = 2114380800;
+
+    uint32_t early_ns = measure_ns_per_call(convert_constant_time, early);
+    uint32_t late_ns = measure_ns_per_call(convert_constant_time, late);
+    uint32_t early_walk_ns = measure_ns_per_call(convert_walk, early);
+    uint32_t late_walk_ns = measure_ns_per_call(convert_walk, late);
+
+    TC_PRINT("Constant time: %u ns in 1971, %u ns in 2037.\n", early_ns, late_ns);
+    TC_PRINT("Year walk: %u ns in 1971, %u ns in 2037.\n", early_walk_ns, late_walk_ns);
+    zassert_true(late_ns * 100 <= early_ns * (100 + BENCHMARK_MAX_GROWTH_PERCENT) + 100,
+                 "The conversion costs %u ns in 1971 and %u ns in 2037.", early_ns, late_ns);
+    zassert_true(late_ns < late_walk_ns, "The conversion costs %u ns, the walk %u ns.", late_ns,
+                 late_walk_ns);
+}
+
+ZTEST_SUITE(calendar, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,110 @@
+/** Tests of the drift compensation.
+ * A counter which is slow by a known amount is simulated, and the device time is read from it
+ * through the drift compensation. The device time is corrected at each synchronization like the
+ * current time service does, and the estimate must converge to the simulated drift.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "datetime/drift.h"
+
+#define COUNTER_FREQUENCY_HZ 32768
+
+// The drift estimate of a fresh device.
+#define INITIAL_PPM 66667
+
+// The estimate must be this close to the simulated drift at the end. It is a bit more than the
+// quantization error of a millisecond in a synchronization interval.
+#define TOLERANCE_PPM 50
+
+typedef struct {
+    int32_t counter_ppm;  // The simulated counter is slow by this.
+    uint64_t real_us;
+    uint64_t counter_ticks;
+    int64_t device_us;
+} simulated_clock_t;
+
+static simulated_clock_t sim_clock;
+
+/* ADVANCE_CLOCK
+ * Let the real time pass, and update the device time from the ticks of the slow counter.
+ */
+static void advance_clock(uint64_t duration_us) {
+    sim_clock.real_us += duration_us;
+    uint64_t counter_ticks = sim_clock.real_us * COUNTER_FREQUENCY_HZ / (1000000 + sim_clock.counter_ppm);
+    uint64_t elapsed_ticks = counter_ticks - sim_clock.counter_ticks;
+    sim_clock.counter_ticks = counter_ticks;
+    sim_clock.device_us += drift_compensated_us(COUNTER_FREQUENCY_HZ, elapsed_ticks);
+}
+
+/* SYNCHRONIZE_CLOCK
+ * Feed the received time to the estimator, and correct the device time with it.
+ */
+static void synchronize_clock() {
+    int64_t reference_ms = sim_clock.real_us / USEC_PER_MSEC;
+    drift_process_sync(sim_clock.device_us / USEC_PER_MSEC, reference_ms);
+    sim_clock.device_us = reference_ms * USEC_PER_MSEC;
+}
+
+/* RUN_SYNCHRONIZATIONS
+ * Synchronize the clock with the period for the duration.
+ */
+static void run_synchronizations(uint32_t period_s, uint32_t duration_s) {
+    for (uint32_t elapsed_s = 0; elapsed_s < duration_s; elapsed_s += period_s) {
+        advance_clock((uint64_t)period_s * USEC_PER_SEC);
+        synchronize_clock();
+    }
+}
+
+static void drift_before(void *fixture) {
+    ARG_UNUSED(fixture);
+
+    // A reference time of zero is never after the previous one, so the estimator starts over.
+    drift_set_ppm(INITIAL_PPM);
+    drift_process_sync(0, 0);
+    sim_clock = (simulated_clock_t){ 0 };
+}
+
+ZTEST(drift, test_hourly_synchronizations_converge) {
+    sim_clock.counter_ppm = 50000;
+    run_synchronizations(3600, 24 * 3600);
+
+    zassert_true(abs(drift_get_ppm() - sim_clock.counter_ppm) <= TOLERANCE_PPM,
+                 "Estimate is %d ppm for a %d ppm counter.", drift_get_ppm(), sim_clock.counter_ppm);
+}
+
+ZTEST(drift, test_frequent_synchronizations_converge) {
+    // Most of the synchronizations are shorter than the minimum interval, but they still correct
+    // the device time. If their errors were hidden from the estimator, each measurement would see
+    // only the last one, and the estimate would still be far off after a few hours.
+    sim_clock.counter_ppm = 80000;
+    run_synchronizations(120, 3 * 3600);
+
+    zassert_true(abs(drift_get_ppm() - sim_clock.counter_ppm) <= TOLERANCE_PPM,
+                 "Estimate is %d ppm for a %d ppm counter.", drift_get_ppm(), sim_clock.counter_ppm);
+}
+
+ZTEST(drift, test_fast_counter_converges) {
+    sim_clock.counter_ppm = -20000;
+    run_synchronizations(1800, 24 * 3600);
+
+    zassert_true(abs(drift_get_ppm() - sim_clock.counter_ppm) <= TOLERANCE_PPM,
+                 "Estimate is %d ppm for a %d ppm counter.", drift_get_ppm(), sim_clock.counter_ppm);
+}
+
+ZTEST(drift, test_compensated_ticks_inverts_compensated_us) {
+    drift_set_ppm(50000);
+    uint64_t ticks = drift_compensated_ticks(COUNTER_FREQUENCY_HZ, 60 * USEC_PER_SEC);
+    uint64_t duration_us = drift_compensated_us(COUNTER_FREQUENCY_HZ, ticks);
+
+    // One tick is about 31 us.
+    zassert_within(duration_us, 60 * USEC_PER_SEC, 32, "A minute of ticks is %llu us.",
+                   (unsigned long long)duration_us);
+}
+
+ZTEST_SUITE(drift, NULL, NULL, drift_before, NULL, NULL);
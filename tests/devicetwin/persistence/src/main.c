@@ -0,0 +1,162 @@
+/** Tests of the device twin persistence.
+ * The twin is saved to the storage partition through the settings subsystem, on the flash
+ * simulator of native_sim. The simulated time runs for hours to count the flash writes per hour of
+ * the ticking time and of the bursts of changes, and the time is restored after a simulated reset.
+ *
+ * The restore duration is measured with the host's clock on native_sim, so it is the flash
+ * simulator's; the duration on the watch's SPI flash is logged by restore_device_twin() at boot.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "datetime/datetime.h"
+#include "datetime/timezone.h"
+#include "devicetwin/devicetwin.h"
+#include "devicetwin/persistence.h"
+
+// The delay and the period of the saves in persistence.c.
+#define SAVE_DELAY_MS (10 * MSEC_PER_SEC)
+#define TIME_SAVE_PERIOD_HOURS 1
+
+#define STEADY_HOURS 6
+
+// A burst sets the time every 10 ms for a second, as a retried synchronization could.
+#define BURST_CHANGES 100
+#define BURST_CHANGE_PERIOD_MS 10
+
+// 2025-01-01 00:00:00 UTC.
+#define TEST_UNIX_TIME_MS 1735689600000LL
+
+/* The test's time zone table, to store the time zone with its name. */
+static const char *const timezone_names[] = { "UTC", "Europe/Berlin" };
+const uint8_t timezone_rule_count = ARRAY_SIZE(timezone_names);
+
+int timezone_find(const char *name) {
+    for (uint8_t i = 0; i < timezone_rule_count; i++) {
+        if (strcmp(timezone_names[i], name) == 0) return i;
+    }
+    return -ENOENT;
+}
+
+const char *timezone_get_name(uint8_t timezone_id) {
+    return timezone_id < timezone_rule_count ? timezone_names[timezone_id] : "UTC";
+}
+
+int16_t timezone_get_offset_minutes(uint8_t timezone_id, int64_t unix_time) {
+    return 0;
+}
+
+/* The scheduler of the datetime subsystem is not used. */
+void wallclock_reschedule() {
+}
+
+/* GET_WRITE_COUNT
+ * Return the flash writes of the persistence since boot.
+ */
+static uint32_t get_write_count(void) {
+    uint32_t write_count, restore_time_us;
+    device_twin_persistence_get_stats(&write_count, &restore_time_us);
+    return write_count;
+}
+
+/* SETTLE
+ * Set the time, and wait for its save. The periodic save is counted from then on.
+ */
+static void settle(void) {
+    zassert_ok(set_current_unix_time_ms(TEST_UNIX_TIME_MS));
+    k_msleep(SAVE_DELAY_MS + MSEC_PER_SEC);
+}
+
+static void *persistence_setup(void) {
+    zassert_not_null(create_device_twin_instance(0, 0));
+    zassert_ok(enable_datetime_subsystem());
+
+    // The flash simulator's file may hold the twin of a previous run.
+    int ret = restore_device_twin();
+    zassert_true(ret == 0 || ret == -ENOENT, "Restore failed (ret %d).", ret);
+    zassert_ok(enable_device_twin_persistence());
+    return NULL;
+}
+
+static void persistence_before(void *fixture) {
+    ARG_UNUSED(fixture);
+    settle();
+}
+
+ZTEST(persistence, test_ticking_time_is_saved_once_per_period) {
+    uint32_t writes_before = get_write_count();
+    k_sleep(K_HOURS(STEADY_HOURS));
+    uint32_t writes = get_write_count() - writes_before;
+
+    TC_PRINT("Ticking time: %u flash writes in %u hours.\n", writes, STEADY_HOURS);
+    zassert_equal(writes, STEADY_HOURS / TIME_SAVE_PERIOD_HOURS, "%u flash writes in %u hours.", writes,
+                  STEADY_HOURS);
+}
+
+ZTEST(persistence, test_burst_of_changes_is_saved_once) {
+    uint32_t writes_before = get_write_count();
+    for (int i = 0; i < BURST_CHANGES; i++) {
+        zassert_ok(set_current_unix_time_ms(TEST_UNIX_TIME_MS + i * MSEC_PER_SEC));
+        zassert_ok(device_twin_set_timezone_id(i % 2));
+        k_msleep(BURST_CHANGE_PERIOD_MS);
+    }
+
+    // Nothing is written until the delay after the first change is over.
+    zassert_equal(get_write_count(), writes_before);
+    k_msleep(SAVE_DELAY_MS);
+    uint32_t writes = get_write_count() - writes_before;
+
+    // The time and the time zone are each saved once.
+    TC_PRINT("Burst: %u flash writes for %u time and %u time zone changes.\n", writes, BURST_CHANGES,
+             BURST_CHANGES);
+    zassert_equal(writes, 2, "%u flash writes for the burst.", writes);
+}
+
+ZTEST(persistence, test_restore_is_not_saved) {
+    zassert_ok(device_twin_set_timezone_id(1));
+    k_msleep(SAVE_DELAY_MS + MSEC_PER_SEC);
+
+    // The storage already holds the restored time and time zone.
+    uint32_t writes_before = get_write_count();
+    zassert_ok(restore_device_twin());
+    k_msleep(SAVE_DELAY_MS + MSEC_PER_SEC);
+    uint32_t writes = get_write_count() - writes_before;
+    zassert_equal(writes, 0, "%u flash writes after the restore.", writes);
+}
+
+ZTEST(persistence, test_restore_adds_elapsed_ticks) {
+    zassert_ok(device_twin_set_timezone_id(1));
+    k_msleep(SAVE_DELAY_MS + MSEC_PER_SEC);
+    k_sleep(K_MINUTES(30));
+    int64_t time_before_reset_ms = get_current_unix_time_ms();
+
+    // A reset which keeps the counter running loses the time and the time zone of the twin.
+    int64_t unix_time_ms;
+    uint32_t counter_value;
+    get_time_base_snapshot(&unix_time_ms, &counter_value);
+    zassert_ok(restore_time_base_snapshot(0, counter_value));
+    zassert_ok(device_twin_set_timezone_id(0));
+    zassert_true(get_current_unix_time_ms() < MSEC_PER_SEC);
+
+    zassert_ok(restore_device_twin());
+    uint32_t write_count, restore_time_us;
+    device_twin_persistence_get_stats(&write_count, &restore_time_us);
+    TC_PRINT("Restore: %u us.\n", restore_time_us);
+
+    // The stored time is half an hour old, the elapsed ticks bring it to the time before the reset.
+    // The two time bases may each round down a counter tick.
+    int64_t time_after_restore_ms = get_current_unix_time_ms();
+    zassert_within(time_after_restore_ms, time_before_reset_ms, 2, "Time is restored to %lld ms, expected "
+                   "%lld ms.", (long long)time_after_restore_ms, (long long)time_before_reset_ms);
+
+    device_twin_t device_twin;
+    zassert_ok(device_twin_snapshot(&device_twin));
+    zassert_equal(device_twin.timezone_id, 1);
+}
+
+ZTEST_SUITE(persistence, NULL, persistence_setup, persistence_before, NULL, NULL);
@@ -0,0 +1,178 @@
+/** Tests of the device twin's sequence lock.
+ * Writer threads and a timer ISR keep writing values whose fields repeat the same number, while
+ * reader threads take snapshots and check that the fields of each snapshot match. A torn snapshot
+ * has fields of two different writes.
+ *
+ * native_sim runs one thread at a time and lets the timer fire only while the time passes, so the
+ * threads interleave between the busy waits of their loops. On a multi-core target, e.g.
+ * qemu_x86_64, the readers also copy the twin while the writers write it.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/ztest.h>
+
+#include "devicetwin/devicetwin.h"
+
+#define WRITER_COUNT 2
+#define READER_COUNT 3
+#define READS_PER_READER 20000
+#define THREAD_STACK_SIZE 1024
+#define THREAD_PRIORITY K_PRIO_PREEMPT(5)
+
+// The timer ISR writes with this period.
+#define ISR_WRITE_PERIOD_US 100
+
+// The time the threads let pass between their operations, which lets the others run.
+#define LOOP_BUSY_WAIT_US 1
+
+// Longer than the coalescing window of the device twin notifications.
+#define NOTIFICATION_WAIT_MS 200
+
+K_THREAD_STACK_ARRAY_DEFINE(writer_stacks, WRITER_COUNT, THREAD_STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(reader_stacks, READER_COUNT, THREAD_STACK_SIZE);
+static struct k_thread writer_threads[WRITER_COUNT];
+static struct k_thread reader_threads[READER_COUNT];
+
+static atomic_t next_value = ATOMIC_INIT(1);
+static atomic_t stop_writers = ATOMIC_INIT(0);
+static atomic_t write_count = ATOMIC_INIT(0);
+static atomic_t torn_count = ATOMIC_INIT(0);
+
+static atomic_t notification_count = ATOMIC_INIT(0);
+static atomic_t notified_fields = ATOMIC_INIT(0);
+
+/* WRITE_VALUE
+ * Write the same number to all the fields of the twin in a single write.
+ */
+static void write_value(void) {
+    uint32_t value = (uint32_t)atomic_inc(&next_value);
+
+    k_spinlock_key_t key;
+    device_twin_t *device_twin = device_twin_write_begin(&key);
+    device_twin->unix_time_ms = ((int64_t)value << 32) | value;
+    device_twin->timezone_id = (uint8_t)value;
+    device_twin_write_commit(key, 0);
+    atomic_inc(&write_count);
+}
+
+/* IS_CONSISTENT
+ * Return whether all the fields of the snapshot belong to the same write.
+ */
+static bool is_consistent(const device_twin_t *snapshot) {
+    uint32_t high = (uint32_t)((uint64_t)snapshot->unix_time_ms >> 32);
+    uint32_t low = (uint32_t)snapshot->unix_time_ms;
+    return high == low && (uint8_t)low == snapshot->timezone_id;
+}
+
+static void isr_writer(struct k_timer *timer) {
+    write_value();
+}
+
+K_TIMER_DEFINE(isr_write_timer, isr_writer, NULL);
+
+static void writer_entry(void *p1, void *p2, void *p3) {
+    while (!atomic_get(&stop_writers)) {
+        write_value();
+        k_busy_wait(LOOP_BUSY_WAIT_US);
+    }
+}
+
+static void reader_entry(void *p1, void *p2, void *p3) {
+    device_twin_t snapshot;
+    for (uint32_t i = 0; i < READS_PER_READER; i++) {
+        if (device_twin_snapshot(&snapshot) != 0 || !is_consistent(&snapshot)) {
+            atomic_inc(&torn_count);
+        }
+        k_busy_wait(LOOP_BUSY_WAIT_US);
+    }
+}
+
+static void device_twin_listener_callback(const struct zbus_channel *chan) {
+    const device_twin_event_t *event = zbus_chan_const_msg(chan);
+    atomic_or(&notified_fields, event->changed_fields);
+    atomic_inc(&notification_count);
+}
+
+ZBUS_LISTENER_DEFINE(test_device_twin_listener, device_twin_listener_callback);
+ZBUS_CHAN_ADD_OBS(device_twin_chan, test_device_twin_listener, 0);
+
+static void *seqlock_setup(void) {
+    create_device_twin_instance(0, 0);
+    return NULL;
+}
+
+static void seqlock_before(void *fixture) {
+    ARG_UNUSED(fixture);
+
+    // Let the notifications of the previous test go out before counting.
+    k_msleep(NOTIFICATION_WAIT_MS);
+    atomic_clear(&notification_count);
+    atomic_clear(&notified_fields);
+}
+
+ZTEST(seqlock, test_snapshot_is_never_torn) {
+    atomic_clear(&stop_writers);
+    atomic_clear(&write_count);
+    atomic_clear(&torn_count);
+
+    for (int i = 0; i < WRITER_COUNT; i++) {
+        k_thread_create(&writer_threads[i], writer_stacks[i], THREAD_STACK_SIZE, writer_entry, NULL, NULL,
+                        NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    }
+    for (int i = 0; i < READER_COUNT; i++) {
+        k_thread_create(&reader_threads[i], reader_stacks[i], THREAD_STACK_SIZE, reader_entry, NULL, NULL,
+                        NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+    }
+    k_timer_start(&isr_write_timer, K_USEC(ISR_WRITE_PERIOD_US), K_USEC(ISR_WRITE_PERIOD_US));
+
+    for (int i = 0; i < READER_COUNT; i++) {
+        k_thread_join(&reader_threads[i], K_FOREVER);
+    }
+    k_timer_stop(&isr_write_timer);
+    atomic_set(&stop_writers, 1);
+    for (int i = 0; i < WRITER_COUNT; i++) {
+        k_thread_join(&writer_threads[i], K_FOREVER);
+    }
+
+    zassert_equal(atomic_get(&torn_count), 0, "%ld of %d snapshots are torn.", atomic_get(&torn_count),
+                  READER_COUNT * READS_PER_READER);
+    zassert_true(atomic_get(&write_count) > READS_PER_READER, "Only %ld writes are done.",
+                 atomic_get(&write_count));
+}
+
+ZTEST(seqlock, test_snapshot_sees_the_last_write) {
+    write_value();
+
+    device_twin_t snapshot;
+    zassert_ok(device_twin_snapshot(&snapshot));
+    zassert_true(is_consistent(&snapshot));
+    zassert_equal((uint32_t)snapshot.unix_time_ms, (uint32_t)atomic_get(&next_value) - 1);
+}
+
+ZTEST(seqlock, test_writes_without_changes_are_not_notified) {
+    for (int i = 0; i < 100; i++) {
+        write_value();
+    }
+    k_msleep(NOTIFICATION_WAIT_MS);
+
+    zassert_equal(atomic_get(&notification_count), 0);
+}
+
+ZTEST(seqlock, test_changes_are_coalesced) {
+    for (int i = 0; i < 10; i++) {
+        device_twin_set_unix_time_ms(i);
+    }
+    device_twin_set_timezone_id(1);
+    device_twin_set_timezone_id(2);
+    k_msleep(NOTIFICATION_WAIT_MS);
+
+    zassert_equal(atomic_get(&notification_count), 1);
+    zassert_equal(atomic_get(&notified_fields), DEVICE_TWIN_FIELD_UNIX_TIME | DEVICE_TWIN_FIELD_TIMEZONE);
+}
+
+ZTEST_SUITE(seqlock, NULL, seqlock_setup, seqlock_before, NULL, NULL);
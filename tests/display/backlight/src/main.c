@@ -0,0 +1,177 @@
+/** Tests of the backlight fades.
+ * The backlight is driven by Zephyr's fake PWM controller, which records each pulse the display
+ * subsystem sets. The fades must step the pulse linearly in time, at the fade step interval, and
+ * end at the target pulse.
+ *
+ * The fake controller counts at 1 GHz, so its cycles are the nanoseconds of the pulse.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/drivers/pwm/pwm_fake.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "display/display.h"
+
+DEFINE_FFF_GLOBALS;
+
+// The backlight's PWM period, and the interval between the pulse changes of a fade, in display.c.
+#define BACKLIGHT_PERIOD_NS 500
+#define FADE_STEP_MS 20
+
+// A step may come a tick late; the ticks are a millisecond.
+#define FADE_STEP_SLACK_MS 2
+
+#define MAX_PULSES 128
+
+typedef struct {
+    int64_t time_ms;
+    uint32_t period_ns;
+    uint32_t pulse_ns;
+} pulse_t;
+
+static pulse_t pulses[MAX_PULSES];
+static uint32_t pulse_count;
+
+/* RECORD_PULSE
+ * Record the pulse set on the fake PWM controller, and the time it is set.
+ */
+static int record_pulse(const struct device *dev, uint32_t channel, uint32_t period_cycles,
+                        uint32_t pulse_cycles, pwm_flags_t flags) {
+    if (pulse_count < MAX_PULSES) {
+        pulses[pulse_count++] = (pulse_t){ k_uptime_get(), period_cycles, pulse_cycles };
+    }
+    return 0;
+}
+
+/* PERCENT_TO_PULSE
+ * Return the pulse of the brightness percentage.
+ */
+static uint32_t percent_to_pulse(uint8_t percent) {
+    return BACKLIGHT_PERIOD_NS * percent / 100;
+}
+
+/* CHECK_FADE
+ * Check the recorded pulses from the first one on against a linear fade which started at the time.
+ * Return the number of the fade's pulses.
+ */
+static uint32_t check_fade(uint32_t first, uint32_t from_ns, uint32_t to_ns, int64_t start_ms,
+                           uint32_t duration_ms) {
+    int64_t delta_ns = (int64_t)to_ns - from_ns;
+    uint32_t count = pulse_count - first;
+    zassert_true(count >= 2, "The fade has %u pulses.", count);
+
+    for (uint32_t i = first; i < pulse_count; i++) {
+        int64_t elapsed_ms = pulses[i].time_ms - start_ms;
+        uint32_t expected_ns = to_ns;
+        if (elapsed_ms < duration_ms) {
+            expected_ns = from_ns + delta_ns * elapsed_ms / duration_ms;
+        }
+
+        zassert_equal(pulses[i].period_ns, BACKLIGHT_PERIOD_NS);
+        zassert_within((int64_t)pulses[i].pulse_ns, (int64_t)expected_ns, 1,
+                       "Pulse is %u ns at %lld ms, expected %u ns.", pulses[i].pulse_ns,
+                       (long long)elapsed_ms, expected_ns);
+        if (i > first) {
+            int64_t interval_ms = pulses[i].time_ms - pulses[i - 1].time_ms;
+            zassert_true(interval_ms >= FADE_STEP_MS && interval_ms <= FADE_STEP_MS + FADE_STEP_SLACK_MS,
+                         "Pulses are %lld ms apart.", (long long)interval_ms);
+            zassert_true(delta_ns > 0 ? pulses[i].pulse_ns >= pulses[i - 1].pulse_ns
+                                      : pulses[i].pulse_ns <= pulses[i - 1].pulse_ns,
+                         "Pulse goes back from %u ns to %u ns.", pulses[i - 1].pulse_ns, pulses[i].pulse_ns);
+        }
+    }
+
+    // The last pulse is the target, set once the duration has passed.
+    zassert_equal(pulses[pulse_count - 1].pulse_ns, to_ns);
+    zassert_true(pulses[pulse_count - 1].time_ms - start_ms >= duration_ms);
+    zassert_true(pulses[pulse_count - 2].time_ms - start_ms < duration_ms);
+    return count;
+}
+
+static void *backlight_setup(void) {
+    zassert_ok(enable_display_subsystem());
+    return NULL;
+}
+
+static void backlight_before(void *fixture) {
+    ARG_UNUSED(fixture);
+
+    // Start each test awake at half brightness, with no fade running.
+    display_wake(0);
+    change_brightness(50);
+    k_msleep(FADE_STEP_MS);
+
+    RESET_FAKE(fake_pwm_set_cycles);
+    fake_pwm_set_cycles_fake.custom_fake = record_pulse;
+    pulse_count = 0;
+}
+
+ZTEST(backlight, test_fade_steps_linearly) {
+    int64_t start_ms = k_uptime_get();
+    zassert_ok(fade_brightness(100, 200));
+    k_msleep(300);
+
+    uint32_t count = check_fade(0, percent_to_pulse(50), percent_to_pulse(100), start_ms, 200);
+    zassert_true(count >= 200 / (FADE_STEP_MS + FADE_STEP_SLACK_MS) + 1 && count <= 200 / FADE_STEP_MS + 2,
+                 "The fade has %u pulses.", count);
+    zassert_equal(get_brightness(), 100);
+}
+
+ZTEST(backlight, test_sleep_fades_out) {
+    int64_t start_ms = k_uptime_get();
+    zassert_ok(display_sleep(400));
+    zassert_true(is_display_asleep());
+    k_msleep(500);
+
+    check_fade(0, percent_to_pulse(50), 0, start_ms, 400);
+
+    // The brightness is kept to restore at wake up, and the changes wait for it.
+    zassert_equal(get_brightness(), 50);
+    uint32_t count = pulse_count;
+    zassert_ok(change_brightness(80));
+    zassert_equal(pulse_count, count);
+}
+
+ZTEST(backlight, test_wake_fades_back_from_current_pulse) {
+    zassert_ok(display_sleep(400));
+    k_msleep(200);
+    uint32_t sleep_count = pulse_count;
+    uint32_t current_ns = pulses[sleep_count - 1].pulse_ns;
+    zassert_true(current_ns > 0 && current_ns < percent_to_pulse(50), "Pulse is %u ns.", current_ns);
+
+    int64_t start_ms = k_uptime_get();
+    zassert_ok(display_wake(200));
+    zassert_false(is_display_asleep());
+    k_msleep(300);
+
+    // The wake fade does not jump to zero or to the brightness, it starts where the sleep fade stopped.
+    check_fade(sleep_count, current_ns, percent_to_pulse(50), start_ms, 200);
+    zassert_equal(pulses[sleep_count].pulse_ns, current_ns);
+}
+
+ZTEST(backlight, test_dim_is_restored_at_wake) {
+    int64_t start_ms = k_uptime_get();
+    zassert_ok(display_dim(10, 100));
+    k_msleep(200);
+    check_fade(0, percent_to_pulse(50), percent_to_pulse(10), start_ms, 100);
+
+    uint32_t dim_count = pulse_count;
+    start_ms = k_uptime_get();
+    zassert_ok(display_wake(100));
+    k_msleep(200);
+    check_fade(dim_count, percent_to_pulse(10), percent_to_pulse(50), start_ms, 100);
+}
+
+ZTEST(backlight, test_change_is_immediate) {
+    zassert_ok(change_brightness(80));
+    zassert_equal(pulse_count, 1);
+    zassert_equal(pulses[0].pulse_ns, percent_to_pulse(80));
+    zassert_equal(change_brightness(101), -EINVAL);
+}
+
+ZTEST_SUITE(backlight, NULL, backlight_setup, backlight_before, NULL, NULL);
@@ -0,0 +1,120 @@
+/** Tests of the RGB565 pixel kernels.
+ * The word-wide kernels are checked against their scalar versions at both alignments of a 16-bit
+ * buffer, at every length up to a few words, and at every opacity. Their throughput is compared
+ * with the scalar versions' on a band of the screen, by the display benchmark's measurement. On
+ * native_sim it is timed with the host's clock.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "display/rgb565.h"
+#include "display/rgb565benchmark.h"
+
+// The lengths checked at each alignment, and the guard pixels around them.
+#define CHECK_MAX_PIXELS 67
+#define GUARD_PIXELS 2
+#define GUARD_PIXEL 0xA5A5
+
+// The blend checks read the source from the opacity on.
+#define SOURCE_PIXELS (UINT8_MAX + 1 + CHECK_MAX_PIXELS)
+
+// A kernel may be this much slower than its scalar version, for the caches and the interrupts.
+#define BENCHMARK_SLACK_PERCENT 10
+
+static uint16_t source[SOURCE_PIXELS] __aligned(4);
+static uint16_t expected[CHECK_MAX_PIXELS + 2 * GUARD_PIXELS] __aligned(4);
+static uint16_t actual[CHECK_MAX_PIXELS + 2 * GUARD_PIXELS] __aligned(4);
+
+/* FILL_BUFFERS
+ * Fill both checked buffers with the same pixels, and the guard pixels around the length from the
+ * offset on.
+ */
+static void fill_buffers(uint32_t offset, uint32_t count) {
+    for (uint32_t i = 0; i < ARRAY_SIZE(expected); i++) {
+        bool guard = i < GUARD_PIXELS + offset || i >= GUARD_PIXELS + offset + count;
+        expected[i] = guard ? GUARD_PIXEL : rgb565_benchmark_pixel(i + count);
+        actual[i] = expected[i];
+    }
+}
+
+/* CHECK_BUFFERS
+ * Check that the kernel and the scalar version wrote the same pixels, and nothing around them.
+ */
+static void check_buffers(const char *name, uint32_t offset, uint32_t count) {
+    zassert_mem_equal(actual, expected, sizeof(expected), "%s differs from scalar with %u pixels at offset "
+                      "%u.", name, count, offset);
+}
+
+static void *rgb565_setup(void) {
+    for (uint32_t i = 0; i < SOURCE_PIXELS; i++) {
+        source[i] = rgb565_benchmark_pixel(i);
+    }
+    return NULL;
+}
+
+ZTEST(rgb565, test_swap_matches_scalar) {
+    for (uint32_t offset = 0; offset < 2; offset++) {
+        for (uint32_t count = 0; count <= CHECK_MAX_PIXELS; count++) {
+            fill_buffers(offset, count);
+            rgb565_swap_scalar(&expected[GUARD_PIXELS + offset], count);
+            rgb565_swap(&actual[GUARD_PIXELS + offset], count);
+            check_buffers("Swap", offset, count);
+        }
+    }
+}
+
+ZTEST(rgb565, test_fill_matches_scalar) {
+    for (uint32_t offset = 0; offset < 2; offset++) {
+        for (uint32_t count = 0; count <= CHECK_MAX_PIXELS; count++) {
+            fill_buffers(offset, count);
+            rgb565_fill_scalar(&expected[GUARD_PIXELS + offset], count, rgb565_benchmark_pixel(count));
+            rgb565_fill(&actual[GUARD_PIXELS + offset], count, rgb565_benchmark_pixel(count));
+            check_buffers("Fill", offset, count);
+        }
+    }
+}
+
+ZTEST(rgb565, test_blend_color_matches_scalar) {
+    for (uint32_t opacity = 0; opacity <= UINT8_MAX; opacity++) {
+        for (uint32_t offset = 0; offset < 2; offset++) {
+            uint32_t count = CHECK_MAX_PIXELS - offset;
+            uint16_t color = rgb565_benchmark_pixel(opacity);
+            fill_buffers(offset, count);
+            rgb565_blend_color_scalar(&expected[GUARD_PIXELS + offset], count, color, opacity);
+            rgb565_blend_color(&actual[GUARD_PIXELS + offset], count, color, opacity);
+            check_buffers("Blend color", offset, count);
+        }
+    }
+}
+
+ZTEST(rgb565, test_blend_matches_scalar) {
+    for (uint32_t opacity = 0; opacity <= UINT8_MAX; opacity++) {
+        for (uint32_t offset = 0; offset < 2; offset++) {
+            uint32_t count = CHECK_MAX_PIXELS - offset;
+            fill_buffers(offset, count);
+            rgb565_blend_scalar(&expected[GUARD_PIXELS + offset], &source[opacity], count, opacity);
+            rgb565_blend(&actual[GUARD_PIXELS + offset], &source[opacity], count, opacity);
+            check_buffers("Blend image", offset, count);
+        }
+    }
+}
+
+ZTEST(rgb565, test_benchmark_throughput) {
+    rgb565_benchmark_result_t results[RGB565_BENCHMARK_KERNEL_COUNT];
+    rgb565_benchmark_run(results);
+
+    for (size_t i = 0; i < ARRAY_SIZE(results); i++) {
+        const rgb565_benchmark_result_t *result = &results[i];
+        TC_PRINT("%s kernel: %u MB/s, scalar %u MB/s.\n", result->name, result->throughput,
+                 result->throughput_scalar);
+        zassert_true(result->throughput * 100 >= result->throughput_scalar * (100 - BENCHMARK_SLACK_PERCENT),
+                     "%s kernel: %u MB/s, scalar %u MB/s.", result->name, result->throughput,
+                     result->throughput_scalar);
+    }
+}
+
+ZTEST_SUITE(rgb565, NULL, rgb565_setup, NULL, NULL, NULL);
@@ -0,0 +1,180 @@
+/** Tests of the energy model with the user interface.
+ * The user interface runs on a dummy display, driven by the test thread as the main thread drives it
+ * on the watch. In the normal mode, touches slide between the home screen and the menu. Then the
+ * display times out into the ambient mode on the home screen, with the refresh and input read timers
+ * paused, and half an hour of minute ticks passes. The frames and the pixels the display event hook
+ * counts in each mode are compared. The CPU-awake time is not checked, since native_sim runs the
+ * code in no simulated time.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include "lvgl.h"
+#include <zephyr/fff.h>
+#include <zephyr/input/input.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "datetime/datetime.h"
+#include "datetime/scheduler.h"
+#include "datetime/timezone.h"
+#include "devicetwin/devicetwin.h"
+#include "display/display.h"
+#include "userinterface/energymodel.h"
+#include "userinterface/navigation.h"
+#include "userinterface/userinterface.h"
+
+DEFINE_FFF_GLOBALS;
+
+#define FULL_FRAME_PIXELS (240 * 240)
+
+// 2025-01-01 12:00:30 UTC, so no midnight passes during the tests.
+#define TEST_UNIX_TIME_MS 1735732830000LL
+
+// The display timeout and the fade out of userinterface.c.
+#define DISPLAY_SLEEP_AFTER_MS 15000
+#define DISPLAY_FADE_OUT_MS 500
+
+// The time the owner loop runs after a touch, to wake the display up and resume the timers.
+#define WAKE_MS 200
+
+// The normal mode slides to the menu and back, once per second of each direction.
+#define NORMAL_SLIDES 10
+#define SLIDE_PERIOD_MS 1000
+
+#define AMBIENT_MINUTES 30
+
+// The ambient mode costs at least this factor less than the sliding normal mode, per hour.
+#define AMBIENT_SAVING_FACTOR 10
+
+/* The watchdog is not used. */
+void watchdog_check_in() {
+}
+
+/* The user interface shows the time in UTC. */
+int16_t timezone_get_offset_minutes(uint8_t timezone_id, int64_t unix_time) {
+    return 0;
+}
+
+int64_t timezone_get_next_transition(uint8_t timezone_id, int64_t unix_time) {
+    return INT64_MAX;
+}
+
+/* RUN_USER_INTERFACE
+ * Run the LVGL-owner loop of the main thread for the given simulated time.
+ */
+static void run_user_interface(uint32_t duration_ms) {
+    int64_t end_ms = k_uptime_get() + duration_ms;
+    while (true) {
+        uint32_t next_call_ms = user_interface_task_handler();
+        int64_t remaining_ms = end_ms - k_uptime_get();
+        if (remaining_ms <= 0) {
+            break;
+        }
+        user_interface_wait(MIN(next_call_ms, (uint32_t)remaining_ms));
+    }
+}
+
+/* TOUCH
+ * Press and release the touch panel, and let the owner loop handle it.
+ */
+static void touch(void) {
+    input_report_key(NULL, INPUT_BTN_TOUCH, 1, false, K_FOREVER);
+    input_report_key(NULL, INPUT_BTN_TOUCH, 0, true, K_FOREVER);
+    run_user_interface(WAKE_MS);
+}
+
+/* GET_COUNTERS
+ * Return the counters of the mode since boot.
+ */
+static energy_counters_t get_counters(energy_mode_t mode) {
+    energy_counters_t counters;
+    energy_model_get_counters(mode, &counters);
+    return counters;
+}
+
+static void *energymodel_setup(void) {
+    zassert_not_null(create_device_twin_instance(TEST_UNIX_TIME_MS, 0));
+    zassert_ok(enable_datetime_subsystem());
+    zassert_ok(set_current_unix_time_ms(TEST_UNIX_TIME_MS));
+    zassert_ok(enable_wallclock_scheduler());
+    zassert_ok(enable_display_subsystem());
+
+    // The test thread owns LVGL from now on.
+    user_interface_init();
+    run_user_interface(WAKE_MS);
+    return NULL;
+}
+
+static void energymodel_before(void *fixture) {
+    ARG_UNUSED(fixture);
+
+    // Start each test awake on the home screen.
+    touch();
+    navigation_reset(SCREEN_HOME);
+    run_user_interface(WAKE_MS);
+    zassert_false(is_display_asleep());
+}
+
+ZTEST(energymodel, test_ambient_mode_refreshes_once_per_minute) {
+    run_user_interface(DISPLAY_SLEEP_AFTER_MS + DISPLAY_FADE_OUT_MS);
+    zassert_true(is_display_asleep(), "The display is not in the ambient mode.");
+
+    energy_counters_t before = get_counters(ENERGY_MODE_AMBIENT);
+    run_user_interface(AMBIENT_MINUTES * 60 * MSEC_PER_SEC);
+    energy_counters_t after = get_counters(ENERGY_MODE_AMBIENT);
+
+    // Only the minute ticks draw, and each redraws a few clock digits.
+    uint32_t frames = after.frame_count - before.frame_count;
+    uint64_t pixels = after.flushed_pixels - before.flushed_pixels;
+    TC_PRINT("Ambient mode: %u frames, %llu pixels in %u minutes.\n", frames, (unsigned long long)pixels,
+             AMBIENT_MINUTES);
+    zassert_within(frames, AMBIENT_MINUTES, 1, "%u frames in %u minutes.", frames, AMBIENT_MINUTES);
+    zassert_true(pixels < (uint64_t)frames * FULL_FRAME_PIXELS / 4, "%llu pixels in %u frames.",
+                 (unsigned long long)pixels, frames);
+}
+
+ZTEST(energymodel, test_touch_ends_ambient_mode) {
+    run_user_interface(DISPLAY_SLEEP_AFTER_MS + DISPLAY_FADE_OUT_MS);
+    zassert_true(is_display_asleep(), "The display is not in the ambient mode.");
+
+    // The full layout is drawn again in the normal mode.
+    energy_counters_t before = get_counters(ENERGY_MODE_NORMAL);
+    touch();
+    energy_counters_t after = get_counters(ENERGY_MODE_NORMAL);
+    zassert_false(is_display_asleep());
+    zassert_true(after.frame_count > before.frame_count, "Nothing is drawn after the touch.");
+}
+
+ZTEST(energymodel, test_ambient_mode_costs_less_than_normal_mode) {
+    for (int i = 0; i < NORMAL_SLIDES; i++) {
+        touch();
+        zassert_ok(navigation_push(SCREEN_MENU, LV_SCR_LOAD_ANIM_MOVE_TOP));
+        run_user_interface(SLIDE_PERIOD_MS);
+        touch();
+        zassert_ok(navigation_pop());
+        run_user_interface(SLIDE_PERIOD_MS);
+    }
+    run_user_interface(DISPLAY_SLEEP_AFTER_MS + AMBIENT_MINUTES * 60 * MSEC_PER_SEC);
+    zassert_true(is_display_asleep(), "The display is not in the ambient mode.");
+
+    energy_rates_t normal, ambient;
+    zassert_ok(energy_model_get_rates(ENERGY_MODE_NORMAL, &normal));
+    zassert_ok(energy_model_get_rates(ENERGY_MODE_AMBIENT, &ambient));
+    TC_PRINT("Normal mode: %llu frames, %llu pixels per hour.\n", (unsigned long long)normal.frame_count,
+             (unsigned long long)normal.flushed_pixels);
+    TC_PRINT("Ambient mode: %llu frames, %llu pixels per hour.\n", (unsigned long long)ambient.frame_count,
+             (unsigned long long)ambient.flushed_pixels);
+
+    zassert_true(ambient.frame_count * AMBIENT_SAVING_FACTOR < normal.frame_count);
+    zassert_true(ambient.flushed_pixels * AMBIENT_SAVING_FACTOR < normal.flushed_pixels);
+}
+
+ZTEST(energymodel, test_unused_mode_has_no_rates) {
+    // The display only blanks on the other screens, which the tests leave before it times out.
+    energy_rates_t rates;
+    zassert_equal(energy_model_get_rates(ENERGY_MODE_SLEEP, &rates), -ENODATA);
+}
+
+ZTEST_SUITE(energymodel, NULL, energymodel_setup, energymodel_before, NULL, NULL);
@@ -0,0 +1,168 @@
+/** Tests of the screen manager and the screen transitions.
+ * The screens are shown and destroyed, or evicted by the budget, thousands of times, and the LVGL
+ * heap must not grow. The slides must run the load hooks of the shown screen once. LVGL draws into a
+ * dummy display, and the test thread owns it.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include "lvgl.h"
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "userinterface/appregistry.h"
+#include "userinterface/screenmanager.h"
+#include "userinterface/screentransition.h"
+#include "userinterface/utils.h"
+#include "userinterface/styles/widgetstyle.h"
+
+#define SCREEN_CYCLES 5000
+
+// The budget of the application, and one which holds no hidden screen.
+#define APPLICATION_BUDGET_BYTES 8192
+#define TINY_BUDGET_BYTES 1
+
+#define SLIDE_MS 100
+#define TRANSITION_TIMEOUT_MS 2000
+
+static uint32_t load_start_count;
+
+/* CYCLE_SCREENS
+ * Show the menu, the pairing and the home screens without animations, and run LVGL's timers, which
+ * also run the pending evictions.
+ */
+static void cycle_screens(void) {
+    screen_manager_show(SCREEN_MENU, LV_SCR_LOAD_ANIM_NONE, 0);
+    screen_manager_show(SCREEN_BLEPAIRING, LV_SCR_LOAD_ANIM_NONE, 0);
+    screen_manager_show(SCREEN_HOME, LV_SCR_LOAD_ANIM_NONE, 0);
+    lv_timer_handler();
+}
+
+/* COUNT_LOAD_START
+ * Count the load hooks of the screen.
+ */
+static void count_load_start(lv_event_t *event) {
+    load_start_count++;
+}
+
+/* RUN_TRANSITION
+ * Run LVGL's timers until the transition is finished, and return whether it finished in time.
+ */
+static bool run_transition(void) {
+    int64_t start_ms = k_uptime_get();
+    while (screen_transition_is_running()) {
+        if (k_uptime_get() - start_ms > TRANSITION_TIMEOUT_MS) {
+            return false;
+        }
+        k_msleep(MIN(lv_timer_handler(), LV_DEF_REFR_PERIOD));
+    }
+    return true;
+}
+
+static void *screenmanager_setup(void) {
+    register_application("settings", "Settings", NULL);
+    register_application("stopwatch", "Stopwatch", NULL);
+    register_application("weather", "Weather", NULL);
+    register_application("music", "Music", NULL);
+    widget_style_init();
+    screen_transition_init();
+    return NULL;
+}
+
+static void screenmanager_before(void *fixture) {
+    ARG_UNUSED(fixture);
+
+    // Start each test from the home screen alone.
+    screen_manager_init(APPLICATION_BUDGET_BYTES);
+    screen_manager_show(SCREEN_HOME, LV_SCR_LOAD_ANIM_NONE, 0);
+    screen_manager_destroy(SCREEN_MENU);
+    screen_manager_destroy(SCREEN_BLEPAIRING);
+    lv_timer_handler();
+}
+
+ZTEST(screenmanager, test_destroyed_screens_do_not_grow_heap) {
+    // The first cycle may allocate LVGL's own objects, which are kept.
+    cycle_screens();
+    screen_manager_destroy(SCREEN_MENU);
+    screen_manager_destroy(SCREEN_BLEPAIRING);
+    uint32_t heap_used_before = get_heap_used();
+
+    for (uint32_t i = 0; i < SCREEN_CYCLES; i++) {
+        cycle_screens();
+        zassert_ok(screen_manager_destroy(SCREEN_MENU));
+        zassert_ok(screen_manager_destroy(SCREEN_BLEPAIRING));
+    }
+    lv_timer_handler();
+    uint32_t heap_used_after = get_heap_used();
+
+    zassert_true(heap_used_after <= heap_used_before, "LVGL heap grew from %u to %u bytes in %u cycles.",
+                 heap_used_before, heap_used_after, SCREEN_CYCLES);
+}
+
+ZTEST(screenmanager, test_evicted_screens_do_not_grow_heap) {
+    // With a budget smaller than any screen, each hidden screen is evicted after it is hidden.
+    screen_manager_init(TINY_BUDGET_BYTES);
+    cycle_screens();
+    uint32_t used_bytes, evictions_before, evictions_after;
+    screen_manager_get_stats(&used_bytes, &evictions_before);
+    uint32_t heap_used_before = get_heap_used();
+
+    for (uint32_t i = 0; i < SCREEN_CYCLES; i++) {
+        cycle_screens();
+    }
+    lv_timer_handler();
+    uint32_t heap_used_after = get_heap_used();
+    screen_manager_get_stats(&used_bytes, &evictions_after);
+
+    zassert_true(heap_used_after <= heap_used_before, "LVGL heap grew from %u to %u bytes in %u cycles.",
+                 heap_used_before, heap_used_after, SCREEN_CYCLES);
+    zassert_true(evictions_after - evictions_before >= 2 * SCREEN_CYCLES, "Only %u screens are evicted.",
+                 evictions_after - evictions_before);
+    zassert_false(screen_manager_is_created(SCREEN_MENU));
+    zassert_false(screen_manager_is_created(SCREEN_BLEPAIRING));
+}
+
+ZTEST(screenmanager, test_shown_and_pinned_screens_are_not_evicted) {
+    screen_manager_init(TINY_BUDGET_BYTES);
+    screen_manager_show(SCREEN_MENU, LV_SCR_LOAD_ANIM_NONE, 0);
+    lv_timer_handler();
+
+    // The menu is shown, and the home screen is pinned.
+    zassert_true(screen_manager_is_created(SCREEN_MENU));
+    zassert_true(screen_manager_is_created(SCREEN_HOME));
+    zassert_equal(screen_manager_get_active(), SCREEN_MENU);
+}
+
+ZTEST(screenmanager, test_slide_runs_load_hooks_once) {
+    static const bool snapshots[] = { true, false };
+
+    // The menu keeps the counting hook over the slides, so it must not be evicted when it is hidden.
+    screen_manager_init(UINT32_MAX);
+    lv_obj_t *menu = screen_manager_get(SCREEN_MENU);
+    zassert_not_null(menu);
+    lv_obj_add_event_cb(menu, count_load_start, LV_EVENT_SCREEN_LOAD_START, NULL);
+
+    for (size_t i = 0; i < ARRAY_SIZE(snapshots); i++) {
+        screen_transition_set_snapshots(snapshots[i]);
+        load_start_count = 0;
+        zassert_ok(screen_transition_start(SCREEN_MENU, LV_SCR_LOAD_ANIM_MOVE_TOP, SLIDE_MS));
+        zassert_true(run_transition(), "The slide to the menu does not finish.");
+
+        screen_transition_stats_t stats;
+        screen_transition_get_stats(&stats);
+        zassert_equal(stats.snapshot, snapshots[i]);
+        zassert_equal(screen_manager_get_active(), SCREEN_MENU);
+        zassert_equal(load_start_count, 1, "The menu's load hooks ran %u times.", load_start_count);
+
+        zassert_ok(screen_transition_start(SCREEN_HOME, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, SLIDE_MS));
+        zassert_true(run_transition(), "The slide to the home screen does not finish.");
+        zassert_equal(load_start_count, 1);
+        zassert_true(screen_manager_is_created(SCREEN_MENU));
+    }
+
+    lv_obj_remove_event_cb(menu, count_load_start);
+    screen_transition_set_snapshots(true);
+}
+
+ZTEST_SUITE(screenmanager, NULL, screenmanager_setup, screenmanager_before, NULL, NULL);
@@ -0,0 +1,134 @@
+/** Tests of the shared style sheet.
+ * Each screen is created with the shared styles, then the shared styles of its objects are replaced
+ * by the same properties set locally. The replacement must not change the look of any object. The
+ * LVGL heap used by each screen in both ways is printed. The local figure is an estimate of the
+ * screens before the style sheet: it sets exactly the style sheet's properties, which the screens
+ * did not, so it is not compared.
+ *
+ * @license GNU v3
+ * @maintainer electricalgorithm @ github
+ */
+
+#include "lvgl.h"
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "userinterface/appregistry.h"
+#include "userinterface/screenmanager.h"
+#include "userinterface/utils.h"
+#include "userinterface/styles/widgetstyle.h"
+
+typedef const lv_style_t* (*style_getter_t)();
+
+static const style_getter_t style_sheet[] = {
+    get_widget_style_no_border, get_widget_style_flex_column, get_widget_style_flex_row,
+    get_widget_style_card, get_widget_style_card_pressed, get_widget_style_digit_row,
+    get_widget_style_digit_box, get_widget_style_title, get_widget_style_text,
+};
+
+// The selectors the screens add the shared styles with.
+static const lv_style_selector_t style_selectors[] = { LV_PART_MAIN, LV_PART_MAIN | LV_STATE_PRESSED };
+
+// The properties the style sheet sets.
+static const lv_style_prop_t style_props[] = {
+    LV_STYLE_LAYOUT, LV_STYLE_FLEX_FLOW, LV_STYLE_FLEX_MAIN_PLACE, LV_STYLE_FLEX_CROSS_PLACE,
+    LV_STYLE_FLEX_TRACK_PLACE, LV_STYLE_PAD_TOP, LV_STYLE_PAD_BOTTOM, LV_STYLE_PAD_LEFT,
+    LV_STYLE_PAD_RIGHT, LV_STYLE_PAD_COLUMN, LV_STYLE_RADIUS, LV_STYLE_BG_COLOR, LV_STYLE_BG_OPA,
+    LV_STYLE_BORDER_COLOR, LV_STYLE_BORDER_WIDTH, LV_STYLE_BORDER_OPA, LV_STYLE_OUTLINE_WIDTH,
+    LV_STYLE_SHADOW_WIDTH, LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_FONT, LV_STYLE_TEXT_ALIGN,
+};
+
+typedef struct {
+    uint32_t style_count;
+    uint32_t prop_count;
+    uint32_t changed_count;
+} localize_result_t;
+
+/* IS_SAME_VALUE
+ * Return whether the two values of the property are equal.
+ */
+static bool is_same_value(lv_style_prop_t prop, lv_style_value_t a, lv_style_value_t b) {
+    if (prop == LV_STYLE_BG_COLOR || prop == LV_STYLE_BORDER_COLOR || prop == LV_STYLE_TEXT_COLOR) {
+        return lv_color_eq(a.color, b.color);
+    }
+    if (prop == LV_STYLE_TEXT_FONT) {
+        return a.ptr == b.ptr;
+    }
+    return a.num == b.num;
+}
+
+/* LOCALIZE_STYLES
+ * Replace the shared styles of the object and its children by their properties set locally, and
+ * count the styles, the properties, and the main part's resolved values which changed.
+ */
+static void localize_styles(lv_obj_t *obj, localize_result_t *result) {
+    lv_style_value_t values_before[ARRAY_SIZE(style_props)];
+    for (size_t i = 0; i < ARRAY_SIZE(style_props); i++) {
+        values_before[i] = lv_obj_get_style_prop(obj, LV_PART_MAIN, style_props[i]);
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(style_sheet); i++) {
+        const lv_style_t *style = style_sheet[i]();
+        for (size_t j = 0; j < ARRAY_SIZE(style_selectors); j++) {
+            // Replacing the style by itself only tells whether the object has it.
+            if (!lv_obj_replace_style(obj, style, style, style_selectors[j])) {
+                continue;
+            }
+            lv_obj_remove_style(obj, style, style_selectors[j]);
+            result->style_count++;
+
+            for (size_t k = 0; k < ARRAY_SIZE(style_props); k++) {
+                lv_style_value_t value;
+                if (lv_style_get_prop(style, style_props[k], &value) == LV_STYLE_RES_FOUND) {
+                    lv_obj_set_local_style_prop(obj, style_props[k], value, style_selectors[j]);
+                    result->prop_count++;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(style_props); i++) {
+        lv_style_value_t value = lv_obj_get_style_prop(obj, LV_PART_MAIN, style_props[i]);
+        if (!is_same_value(style_props[i], values_before[i], value)) {
+            result->changed_count++;
+        }
+    }
+
+    for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++) {
+        localize_styles(lv_obj_get_child(obj, i), result);
+    }
+}
+
+static void *styles_setup(void) {
+    register_application("settings", "Settings", NULL);
+    register_application("stopwatch", "Stopwatch", NULL);
+    register_application("weather", "Weather", NULL);
+    register_application("music", "Music", NULL);
+    widget_style_init();
+    return NULL;
+}
+
+ZTEST(styles, test_local_styles_keep_the_look) {
+    for (screen_id_t id = 0; id < SCREEN_COUNT; id++) {
+        uint32_t heap_used_before = get_heap_used();
+        lv_obj_t *screen = screen_manager_get(id);
+        zassert_not_null(screen);
+        uint32_t shared_bytes = get_heap_used() - heap_used_before;
+
+        localize_result_t result = { 0 };
+        localize_styles(screen, &result);
+        uint32_t local_bytes = get_heap_used() - heap_used_before;
+
+        TC_PRINT("%s screen: %u bytes with shared styles, an estimated %u bytes with local styles, %u "
+                 "styles with %u properties.\n", screen_manager_get_name(id), shared_bytes, local_bytes,
+                 result.style_count, result.prop_count);
+        zassert_equal(result.changed_count, 0, "%u properties of %s screen changed.", result.changed_count,
+                      screen_manager_get_name(id));
+        zassert_true(result.style_count > 0, "%s screen has no shared style.", screen_manager_get_name(id));
+
+        // The screen is never loaded, so it can be deleted.
+        zassert_ok(screen_manager_destroy(id));
+    }
+}
+
+ZTEST_SUITE(styles, NULL, styles_setup, NULL, NULL, NULL);